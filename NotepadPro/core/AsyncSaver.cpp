@@ -0,0 +1,105 @@
+/**
+ * @file AsyncSaver.cpp
+ * @brief 后台保存管线实现
+ *
+ * 知识点：
+ * - QThreadPool::setMaxThreadCount(1) 保证写入按顺序串行执行
+ * - QFutureWatcher::waitForFinished() 退出前同步等待
+ */
+
+#include "AsyncSaver.h"
+
+#include <QtConcurrent>
+
+/**
+ * @brief 构造函数
+ * @param factory 任务工厂（在 GUI 线程调用）
+ * @param parent 父对象指针
+ */
+AsyncSaver::AsyncSaver(const JobFactory &factory, QObject *parent)
+    : QObject(parent)
+    , m_factory(factory)
+    , m_watcher(new QFutureWatcher<bool>(this))
+    , m_inFlight(false)
+    , m_pending(false)
+{
+    m_pool.setMaxThreadCount(1);
+    connect(m_watcher, &QFutureWatcher<bool>::finished,
+            this, &AsyncSaver::finishJob);
+}
+
+/**
+ * @brief 析构函数
+ *
+ * 等待正在执行的写入完成，避免写到一半被打断
+ */
+AsyncSaver::~AsyncSaver()
+{
+    m_pending = false;
+    m_watcher->waitForFinished();
+}
+
+/**
+ * @brief 请求保存
+ *
+ * 空闲时立即开始；已有任务在执行时只标记待保存
+ */
+void AsyncSaver::requestSave()
+{
+    if (m_inFlight) {
+        m_pending = true;
+        return;
+    }
+    startJob();
+}
+
+/**
+ * @brief 是否有正在执行或等待执行的保存
+ * @return 忙碌返回 true
+ */
+bool AsyncSaver::isBusy() const
+{
+    return m_inFlight || m_pending;
+}
+
+/**
+ * @brief 同步等待全部保存完成（包括待保存的那一次）
+ *
+ * 退出程序或需要同步写入前调用
+ */
+void AsyncSaver::waitForIdle()
+{
+    while (m_inFlight) {
+        m_watcher->waitForFinished();
+        finishJob();
+    }
+}
+
+/**
+ * @brief 在 GUI 线程拍快照，并把写入函数交给工作线程
+ */
+void AsyncSaver::startJob()
+{
+    m_pending = false;
+    m_inFlight = true;
+    const Job job = m_factory();
+    m_watcher->setFuture(QtConcurrent::run(&m_pool, job));
+}
+
+/**
+ * @brief 任务结束（GUI 线程）
+ *
+ * waitForIdle() 可能已经手动处理过同一个任务，用 m_inFlight 防止重复处理
+ */
+void AsyncSaver::finishJob()
+{
+    if (!m_inFlight) {
+        return;
+    }
+    m_inFlight = false;
+    emit saveFinished(m_watcher->result());
+
+    if (m_pending) {
+        startJob();
+    }
+}
@@ -0,0 +1,61 @@
+/**
+ * @file AsyncSaver.h
+ * @brief 后台保存管线
+ *
+ * 知识点：
+ * - QThreadPool 限制为单线程，作为专用的保存工作线程
+ * - QtConcurrent::run() 把任务交给线程池
+ * - QFutureWatcher 在 GUI 线程接收完成通知
+ * - 请求合并：最多一个正在执行、一个等待执行
+ */
+
+#ifndef ASYNCSAVER_H
+#define ASYNCSAVER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QFutureWatcher>
+
+#include <functional>
+
+/**
+ * @class AsyncSaver
+ * @brief 合并保存请求并在工作线程中执行
+ *
+ * 任务分两步：
+ * 1. 任务工厂在 GUI 线程调用，廉价地拍下当前数据的快照（记录拷贝）
+ * 2. 工厂返回的写入函数在工作线程中执行序列化和写盘
+ *
+ * 保存进行中再次请求时只标记“待保存”，当前任务结束后重新拍快照执行一次，
+ * 因此连续多次请求最终只会多写一次，且写入的总是最新数据
+ */
+class AsyncSaver : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Job = std::function<bool()>;
+    using JobFactory = std::function<Job()>;
+
+    explicit AsyncSaver(const JobFactory &factory, QObject *parent = nullptr);
+    ~AsyncSaver() override;
+
+    void requestSave();
+    bool isBusy() const;
+    void waitForIdle();
+
+signals:
+    void saveFinished(bool ok);
+
+private:
+    void startJob();
+    void finishJob();
+
+    JobFactory m_factory;
+    QThreadPool m_pool;
+    QFutureWatcher<bool> *m_watcher;
+    bool m_inFlight;
+    bool m_pending;
+};
+
+#endif // ASYNCSAVER_H
@@ -0,0 +1,750 @@
+/**
+ * @file BinarySnapshot.cpp
+ * @brief 二进制数据快照实现
+ *
+ * 知识点：
+ * - QSaveFile 原子写入
+ * - 两遍写入：先计算字符串堆偏移写出记录表，再顺序写出字符串
+ * - QFile::map()/unmap() 内存映射
+ * - QDateTime::toMSecsSinceEpoch() 毫秒时间戳，避免解析 ISO 字符串
+ * - qCompress() 压缩正文块，QMutex 保护多线程共享的解压缓存
+ */
+
+#include "BinarySnapshot.h"
+
+#include <QSaveFile>
+#include <QMutexLocker>
+#include <QUuid>
+#include <QtEndian>
+
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace {
+
+const char kMagic[4] = { 'N', 'P', 'S', 'B' };
+// 版本 1：正文在字符串堆中；版本 2：正文分块压缩；版本 3：ID 可以是字符串（见条目标志位）
+// 写出时使用所需的最低版本，不含字符串 ID 的文件旧版本程序仍能读取
+const quint16 kVersion = 3;
+const quint16 kPlainVersion = 1;
+const quint16 kCompressedVersion = 2;
+
+// 文件头标志位
+const quint16 kCompressedContent = 0x1;
+
+// 笔记标志位
+const quint32 kNotePinned = 0x1;
+
+// 笔记/分类共用的 ID 标志位：ID 不是规范形式的 UUID（例如从其他程序导入的数据）时，
+// 以字符串形式放在字符串堆中，16 字节的 ID 字段改存它的堆引用
+const quint32 kStringId = 0x2;          // id
+const quint32 kStringRelatedId = 0x4;   // 笔记的 categoryId / 分类的 parentId
+
+// 压缩块的目标大小（未压缩字节数），单条正文更大时独占一块
+const quint64 kBlockSize = 128 * 1024;
+// 解压块缓存容量（字节）
+const int kBlockCacheSize = 8 * 1024 * 1024;
+
+// 无效时间戳
+const qint64 kInvalidTime = std::numeric_limits<qint64>::min();
+
+/**
+ * @brief 字符串堆引用：偏移（字节，相对堆起点）+ 长度（UTF-16 码元数）
+ */
+struct StringRef
+{
+    quint64 offset;
+    quint64 length;
+};
+
+/**
+ * @brief 文件头，固定 64 字节
+ */
+struct FileHeader
+{
+    char magic[4];
+    quint16 version;
+    quint16 flags;
+    quint32 noteCount;
+    quint32 categoryCount;
+    quint64 noteTableOffset;
+    quint64 categoryTableOffset;
+    quint64 heapOffset;
+    quint64 heapSize;
+    quint64 blockTableOffset;
+    quint64 blockCount;
+};
+
+/**
+ * @brief 笔记表条目，固定 88 字节
+ */
+struct NoteEntry
+{
+    uchar id[16];
+    uchar categoryId[16];
+    qint64 createdAt;
+    qint64 updatedAt;
+    StringRef title;
+    StringRef content;
+    quint32 flags;
+    quint32 reserved;
+};
+
+/**
+ * @brief 分类表条目，固定 56 字节
+ */
+struct CategoryEntry
+{
+    uchar id[16];
+    uchar parentId[16];
+    StringRef name;
+    quint32 color;
+    quint32 flags;      // 版本 3 之前恒为 0
+};
+
+/**
+ * @brief 压缩块表条目，固定 24 字节
+ *
+ * rawOffset 是块在“全部正文顺序拼接后的 UTF-16 字节流”中的起点，
+ * 笔记表中正文的 offset 也使用这个坐标
+ */
+struct BlockEntry
+{
+    quint64 rawOffset;
+    quint64 fileOffset;
+    quint32 compressedSize;
+    quint32 rawSize;
+};
+
+/**
+ * @brief 写入时规划的压缩块（连续的若干条笔记）
+ */
+struct ContentBlock
+{
+    int firstNote;
+    int noteCount;
+    quint64 rawSize;
+};
+
+static_assert(sizeof(StringRef) == 16, "StringRef must fit in an ID field");
+static_assert(sizeof(FileHeader) == 64, "FileHeader must be 64 bytes");
+static_assert(sizeof(BlockEntry) == 24, "BlockEntry must be 24 bytes");
+static_assert(sizeof(NoteEntry) == 88, "NoteEntry must be 88 bytes");
+static_assert(sizeof(CategoryEntry) == 56, "CategoryEntry must be 56 bytes");
+
+quint64 align8(quint64 value)
+{
+    return (value + 7) & ~quint64(7);
+}
+
+/**
+ * @brief UUID 字符串转 16 字节二进制，空字符串写为全零
+ * @return 字符串不是规范形式（小写、不带花括号）的 UUID 时返回 false，
+ *         此时二进制形式无法原样还原，应改存为字符串
+ */
+bool packUuid(const QString &text, uchar *out)
+{
+    if (text.isEmpty()) {
+        std::memset(out, 0, 16);
+        return true;
+    }
+    const QUuid uuid = QUuid::fromString(text);
+    if (uuid.isNull() || uuid.toString(QUuid::WithoutBraces) != text) {
+        return false;
+    }
+    const QByteArray bytes = uuid.toRfc4122();
+    std::memcpy(out, bytes.constData(), 16);
+    return true;
+}
+
+/**
+ * @brief ID 能否存为 16 字节二进制
+ */
+bool isPackableId(const QString &text)
+{
+    uchar bytes[16];
+    return packUuid(text, bytes);
+}
+
+/**
+ * @brief 16 字节二进制转 UUID 字符串，全零还原为空字符串
+ */
+QString unpackUuid(const uchar *bytes)
+{
+    const QUuid uuid = QUuid::fromRfc4122(
+        QByteArray::fromRawData(reinterpret_cast<const char *>(bytes), 16));
+    return uuid.isNull() ? QString() : uuid.toString(QUuid::WithoutBraces);
+}
+
+qint64 packTime(const QDateTime &time)
+{
+    return time.isValid() ? time.toMSecsSinceEpoch() : kInvalidTime;
+}
+
+QDateTime unpackTime(qint64 msecs)
+{
+    return msecs == kInvalidTime ? QDateTime() : QDateTime::fromMSecsSinceEpoch(msecs);
+}
+
+/**
+ * @brief 为字符串在堆中分配位置
+ * @param length 字符串长度（UTF-16 码元数）
+ * @param heapSize 当前堆大小，分配后增加
+ * @return 小端字节序的堆引用
+ */
+StringRef placeString(qint64 length, quint64 &heapSize)
+{
+    StringRef ref;
+    ref.offset = qToLittleEndian<quint64>(heapSize);
+    ref.length = qToLittleEndian<quint64>(quint64(length));
+    heapSize += quint64(length) * 2;
+    return ref;
+}
+
+/**
+ * @brief 写入 ID 字段：UUID 存为 16 字节二进制，其他 ID 在字符串堆中分配位置
+ * @param text ID
+ * @param out 16 字节的 ID 字段
+ * @param heapSize 当前堆大小，存为字符串时增加
+ * @return 存为字符串时返回 true（调用方设置对应的标志位，第二遍写出字符串）
+ */
+bool packId(const QString &text, uchar *out, quint64 &heapSize)
+{
+    if (packUuid(text, out)) {
+        return false;
+    }
+    const StringRef ref = placeString(text.size(), heapSize);
+    std::memcpy(out, &ref, sizeof(ref));
+    return true;
+}
+
+/**
+ * @brief 从 UTF-16 小端数据构造字符串
+ */
+QString decodeUtf16(const uchar *p, quint64 length)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    return QString(reinterpret_cast<const QChar *>(p), int(length));
+#else
+    QString text(int(length), Qt::Uninitialized);
+    qFromLittleEndian<quint16>(p, int(length), text.data());
+    return text;
+#endif
+}
+
+/**
+ * @brief 以 UTF-16 小端格式追加到缓冲区
+ */
+void appendString(QByteArray &buffer, const QString &text)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    buffer.append(reinterpret_cast<const char *>(text.constData()), text.size() * 2);
+#else
+    const int start = buffer.size();
+    buffer.resize(start + text.size() * 2);
+    qToLittleEndian<quint16>(text.constData(), text.size(), buffer.data() + start);
+#endif
+}
+
+/**
+ * @brief 写出填充字节，使文件位置对齐到 8 字节
+ */
+bool padTo8(QIODevice &device, quint64 position)
+{
+    const int padding = int(align8(position) - position);
+    return padding == 0 || device.write(QByteArray(padding, '\0')) == padding;
+}
+
+/**
+ * @brief 以 UTF-16 小端格式写出字符串
+ */
+bool writeString(QIODevice &device, const QString &text)
+{
+    if (text.isEmpty()) {
+        return true;
+    }
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    const qint64 bytes = qint64(text.size()) * 2;
+    return device.write(reinterpret_cast<const char *>(text.constData()), bytes) == bytes;
+#else
+    QByteArray buffer(text.size() * 2, Qt::Uninitialized);
+    qToLittleEndian<quint16>(text.constData(), text.size(), buffer.data());
+    return device.write(buffer) == buffer.size();
+#endif
+}
+
+/**
+ * @brief 写出 packId() 在字符串堆中分配的 ID（存为二进制的 ID 不写）
+ */
+bool writeId(QIODevice &device, const QString &text)
+{
+    return isPackableId(text) || writeString(device, text);
+}
+
+}
+
+/**
+ * @brief 构造函数
+ */
+BinarySnapshot::BinarySnapshot()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_noteCount(0)
+    , m_categoryCount(0)
+    , m_noteTableOffset(0)
+    , m_categoryTableOffset(0)
+    , m_heapOffset(0)
+    , m_heapSize(0)
+    , m_compressed(false)
+    , m_blockTableOffset(0)
+    , m_blockCount(0)
+{
+    m_blockCache.setMaxCost(kBlockCacheSize);
+}
+
+/**
+ * @brief 析构函数，解除内存映射
+ */
+BinarySnapshot::~BinarySnapshot()
+{
+    close();
+}
+
+/**
+ * @brief 打开并映射快照文件
+ * @param path 文件路径
+ * @return 文件格式正确返回 true
+ *
+ * 知识点：
+ * - QFile::map() 返回的指针在 unmap() 或文件关闭前一直有效
+ * - 打开时只校验文件头和各区段边界，不解码任何记录
+ */
+bool BinarySnapshot::open(const QString &path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < qint64(sizeof(FileHeader))) {
+        close();
+        return false;
+    }
+
+    uchar *data = m_file.map(0, m_size);
+    if (!data) {
+        close();
+        return false;
+    }
+    m_data = data;
+
+    FileHeader header;
+    std::memcpy(&header, m_data, sizeof(header));
+    const quint16 version = qFromLittleEndian(header.version);
+    if (std::memcmp(header.magic, kMagic, 4) != 0 || version == 0 || version > kVersion) {
+        close();
+        return false;
+    }
+
+    m_noteCount = int(qFromLittleEndian(header.noteCount));
+    m_categoryCount = int(qFromLittleEndian(header.categoryCount));
+    m_noteTableOffset = qFromLittleEndian(header.noteTableOffset);
+    m_categoryTableOffset = qFromLittleEndian(header.categoryTableOffset);
+    m_heapOffset = qFromLittleEndian(header.heapOffset);
+    m_heapSize = qFromLittleEndian(header.heapSize);
+    m_compressed = version >= 2 && (qFromLittleEndian(header.flags) & kCompressedContent);
+    m_blockTableOffset = m_compressed ? qFromLittleEndian(header.blockTableOffset) : 0;
+    m_blockCount = m_compressed ? int(qFromLittleEndian(header.blockCount)) : 0;
+
+    const quint64 size = quint64(m_size);
+    const bool valid =
+        m_noteTableOffset + quint64(m_noteCount) * sizeof(NoteEntry) <= size &&
+        m_categoryTableOffset + quint64(m_categoryCount) * sizeof(CategoryEntry) <= size &&
+        m_heapOffset + m_heapSize <= size &&
+        m_blockTableOffset + quint64(m_blockCount) * sizeof(BlockEntry) <= size;
+    if (!valid) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 解除映射并关闭文件
+ */
+void BinarySnapshot::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = nullptr;
+    }
+    m_file.close();
+    m_size = 0;
+    m_noteCount = 0;
+    m_categoryCount = 0;
+    m_compressed = false;
+    m_blockCount = 0;
+
+    QMutexLocker locker(&m_blockMutex);
+    m_blockCache.clear();
+}
+
+bool BinarySnapshot::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+int BinarySnapshot::noteCount() const
+{
+    return m_noteCount;
+}
+
+int BinarySnapshot::categoryCount() const
+{
+    return m_categoryCount;
+}
+
+/**
+ * @brief 解码第 index 条笔记
+ * @param index 笔记序号
+ * @param withContent 是否读取正文；为 false 时只记录正文位置（需由 QSharedPointer 持有）
+ * @return 笔记记录
+ */
+NoteRecord BinarySnapshot::note(int index, bool withContent) const
+{
+    NoteEntry entry;
+    std::memcpy(&entry, m_data + m_noteTableOffset + quint64(index) * sizeof(NoteEntry),
+                sizeof(entry));
+
+    const quint32 flags = qFromLittleEndian(entry.flags);
+    NoteRecord record;
+    record.id = idString(entry.id, flags & kStringId);
+    record.categoryId = idString(entry.categoryId, flags & kStringRelatedId);
+    record.createdAt = unpackTime(qFromLittleEndian(entry.createdAt));
+    record.updatedAt = unpackTime(qFromLittleEndian(entry.updatedAt));
+    record.title = heapString(qFromLittleEndian(entry.title.offset),
+                              qFromLittleEndian(entry.title.length));
+    const quint64 contentOffset = qFromLittleEndian(entry.content.offset);
+    const quint64 contentLength = qFromLittleEndian(entry.content.length);
+    if (withContent) {
+        record.content = readContent(qint64(contentOffset), qint64(contentLength));
+    } else {
+        record.contentRef.source = sharedFromThis();
+        record.contentRef.offset = qint64(contentOffset);
+        record.contentRef.length = qint64(contentLength);
+    }
+    record.isPinned = flags & kNotePinned;
+    return record;
+}
+
+/**
+ * @brief 解码第 index 个分类
+ * @param index 分类序号
+ * @return 分类记录
+ */
+CategoryRecord BinarySnapshot::category(int index) const
+{
+    CategoryEntry entry;
+    std::memcpy(&entry, m_data + m_categoryTableOffset + quint64(index) * sizeof(CategoryEntry),
+                sizeof(entry));
+
+    const quint32 flags = qFromLittleEndian(entry.flags);
+    CategoryRecord record;
+    record.id = idString(entry.id, flags & kStringId);
+    record.parentId = idString(entry.parentId, flags & kStringRelatedId);
+    record.name = heapString(qFromLittleEndian(entry.name.offset),
+                             qFromLittleEndian(entry.name.length));
+    record.color = QColor::fromRgba(qFromLittleEndian(entry.color));
+    return record;
+}
+
+/**
+ * @brief 解码 ID 字段
+ * @param bytes 16 字节的 ID 字段
+ * @param isString 条目标志位表明 ID 存为字符串（字段中是堆引用）
+ */
+QString BinarySnapshot::idString(const uchar *bytes, bool isString) const
+{
+    if (!isString) {
+        return unpackUuid(bytes);
+    }
+    StringRef ref;
+    std::memcpy(&ref, bytes, sizeof(ref));
+    return heapString(qFromLittleEndian(ref.offset), qFromLittleEndian(ref.length));
+}
+
+/**
+ * @brief 读取按需加载的正文
+ * @param offset 正文在字符串堆（或压缩正文流）中的字节偏移
+ * @param length 正文长度（UTF-16 码元数）
+ * @return 正文文本
+ *
+ * 映射区只读，解压缓存由互斥锁保护，多个线程同时读取是安全的
+ */
+QString BinarySnapshot::readContent(qint64 offset, qint64 length) const
+{
+    if (m_compressed) {
+        return blockString(quint64(offset), quint64(length));
+    }
+    return heapString(quint64(offset), quint64(length));
+}
+
+/**
+ * @brief 从字符串堆读取字符串
+ * @param offset 相对堆起点的字节偏移
+ * @param length UTF-16 码元数
+ * @return 字符串，越界时返回空字符串
+ */
+QString BinarySnapshot::heapString(quint64 offset, quint64 length) const
+{
+    if (length == 0 || offset + length * 2 > m_heapSize) {
+        return QString();
+    }
+    return decodeUtf16(m_data + m_heapOffset + offset, length);
+}
+
+/**
+ * @brief 从压缩块读取正文
+ * @param offset 正文在压缩正文流中的字节偏移
+ * @param length UTF-16 码元数
+ * @return 字符串，越界或数据损坏时返回空字符串
+ *
+ * 知识点：
+ * - 块表按 rawOffset 递增排列，二分查找正文所在的块
+ * - 写入时保证一条正文不会跨块
+ * - 解压在锁外进行，锁只保护缓存本身；QByteArray 的引用计数是原子的，可以跨线程共享
+ */
+QString BinarySnapshot::blockString(quint64 offset, quint64 length) const
+{
+    if (length == 0 || m_blockCount == 0) {
+        return QString();
+    }
+
+    auto blockAt = [this](int index) {
+        BlockEntry entry;
+        std::memcpy(&entry, m_data + m_blockTableOffset + quint64(index) * sizeof(BlockEntry),
+                    sizeof(entry));
+        return entry;
+    };
+
+    int low = 0;
+    int high = m_blockCount - 1;
+    int found = -1;
+    while (low <= high) {
+        const int mid = (low + high) / 2;
+        if (qFromLittleEndian(blockAt(mid).rawOffset) <= offset) {
+            found = mid;
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    if (found < 0) {
+        return QString();
+    }
+    const BlockEntry entry = blockAt(found);
+
+    QByteArray block;
+    {
+        QMutexLocker locker(&m_blockMutex);
+        if (const QByteArray *cached = m_blockCache.object(found)) {
+            block = *cached;
+        }
+    }
+    if (block.isNull()) {
+        const quint64 fileOffset = qFromLittleEndian(entry.fileOffset);
+        const quint32 compressedSize = qFromLittleEndian(entry.compressedSize);
+        if (fileOffset + compressedSize > quint64(m_size)) {
+            return QString();
+        }
+        block = qUncompress(m_data + fileOffset, int(compressedSize));
+        if (quint32(block.size()) != qFromLittleEndian(entry.rawSize)) {
+            return QString();
+        }
+        QMutexLocker locker(&m_blockMutex);
+        m_blockCache.insert(found, new QByteArray(block), qMax(1, block.size()));
+    }
+
+    const quint64 start = offset - qFromLittleEndian(entry.rawOffset);
+    if (start + length * 2 > quint64(block.size())) {
+        return QString();
+    }
+    return decodeUtf16(reinterpret_cast<const uchar *>(block.constData()) + start, length);
+}
+
+/**
+ * @brief 写入二进制快照
+ * @param path 文件路径
+ * @param notes 笔记记录
+ * @param categories 分类记录
+ * @return 写入成功返回 true
+ *
+ * @param compressContent 是否分块压缩正文（写出版本 2 文件）
+ *
+ * 知识点：
+ * - 不访问任何 QObject，可以在工作线程中调用
+ * - ID 不是规范形式的 UUID 时存为字符串并设置条目标志位，写出版本 3 文件
+ * - 压缩块的大小写出后才知道，块表放在文件末尾，最后再回到开头重写文件头
+ * - 不压缩且没有字符串 ID 时写出版本 1 文件，旧版本程序也能读取
+ */
+bool BinarySnapshot::write(const QString &path, const QList<NoteRecord> &notes,
+                           const QList<CategoryRecord> &categories, bool compressContent)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    const quint64 noteTableOffset = sizeof(FileHeader);
+    const quint64 categoryTableOffset = noteTableOffset + quint64(notes.size()) * sizeof(NoteEntry);
+    const quint64 heapOffset = align8(categoryTableOffset +
+                                      quint64(categories.size()) * sizeof(CategoryEntry));
+    quint64 heapSize = 0;
+    quint64 contentStreamSize = 0;
+    QList<ContentBlock> blocks;
+    bool hasStringIds = false;
+
+    // 第一遍：生成记录表，计算字符串在堆中（或压缩正文流中）的位置
+    QByteArray tables;
+    tables.reserve(int(heapOffset - noteTableOffset));
+
+    for (int i = 0; i < notes.size(); ++i) {
+        const NoteRecord &note = notes.at(i);
+        NoteEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        quint32 flags = note.isPinned ? kNotePinned : 0;
+        flags |= packId(note.id, entry.id, heapSize) ? kStringId : 0;
+        flags |= packId(note.categoryId, entry.categoryId, heapSize) ? kStringRelatedId : 0;
+        hasStringIds = hasStringIds || (flags & (kStringId | kStringRelatedId));
+        entry.createdAt = qToLittleEndian(packTime(note.createdAt));
+        entry.updatedAt = qToLittleEndian(packTime(note.updatedAt));
+        entry.title = placeString(note.title.size(), heapSize);
+        if (compressContent) {
+            const quint64 bytes = quint64(note.contentSize()) * 2;
+            if (blocks.isEmpty() || (blocks.last().rawSize > 0
+                                     && blocks.last().rawSize + bytes > kBlockSize)) {
+                blocks.append({i, 0, 0});
+            }
+            ++blocks.last().noteCount;
+            blocks.last().rawSize += bytes;
+            entry.content = placeString(note.contentSize(), contentStreamSize);
+        } else {
+            entry.content = placeString(note.contentSize(), heapSize);
+        }
+        entry.flags = qToLittleEndian<quint32>(flags);
+        tables.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+    }
+
+    for (const CategoryRecord &cat : categories) {
+        CategoryEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        quint32 flags = packId(cat.id, entry.id, heapSize) ? kStringId : 0;
+        flags |= packId(cat.parentId, entry.parentId, heapSize) ? kStringRelatedId : 0;
+        hasStringIds = hasStringIds || flags != 0;
+        entry.name = placeString(cat.name.size(), heapSize);
+        entry.color = qToLittleEndian<quint32>(cat.color.rgba());
+        entry.flags = qToLittleEndian<quint32>(flags);
+        tables.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+    }
+    tables.append(QByteArray(int(heapOffset - noteTableOffset) - tables.size(), '\0'));
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, 4);
+    header.version = qToLittleEndian(hasStringIds ? kVersion
+                                     : compressContent ? kCompressedVersion : kPlainVersion);
+    header.flags = qToLittleEndian<quint16>(compressContent ? kCompressedContent : 0);
+    header.noteCount = qToLittleEndian<quint32>(quint32(notes.size()));
+    header.categoryCount = qToLittleEndian<quint32>(quint32(categories.size()));
+    header.noteTableOffset = qToLittleEndian(noteTableOffset);
+    header.categoryTableOffset = qToLittleEndian(categoryTableOffset);
+    header.heapOffset = qToLittleEndian(heapOffset);
+    header.heapSize = qToLittleEndian(heapSize);
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(tables);
+
+    // 第二遍：按相同顺序写出字符串堆
+    for (const NoteRecord &note : notes) {
+        if (!writeId(file, note.id) || !writeId(file, note.categoryId)
+                || !writeString(file, note.title)
+                || (!compressContent && !writeString(file, note.loadContent()))) {
+            file.cancelWriting();
+            return false;
+        }
+    }
+    for (const CategoryRecord &cat : categories) {
+        if (!writeId(file, cat.id) || !writeId(file, cat.parentId) || !writeString(file, cat.name)) {
+            file.cancelWriting();
+            return false;
+        }
+    }
+
+    if (compressContent) {
+        // 逐块拼接、压缩、写出，同一时刻只持有一个块
+        quint64 fileOffset = heapOffset + heapSize;
+        if (!padTo8(file, fileOffset)) {
+            file.cancelWriting();
+            return false;
+        }
+        fileOffset = align8(fileOffset);
+
+        QByteArray blockTable;
+        quint64 rawOffset = 0;
+        for (const ContentBlock &block : std::as_const(blocks)) {
+            QByteArray raw;
+            raw.reserve(int(block.rawSize));
+            for (int i = block.firstNote; i < block.firstNote + block.noteCount; ++i) {
+                appendString(raw, notes.at(i).loadContent());
+            }
+            const QByteArray packed = qCompress(raw);
+            if (quint64(raw.size()) != block.rawSize || file.write(packed) != packed.size()) {
+                file.cancelWriting();
+                return false;
+            }
+
+            BlockEntry entry;
+            entry.rawOffset = qToLittleEndian(rawOffset);
+            entry.fileOffset = qToLittleEndian(fileOffset);
+            entry.compressedSize = qToLittleEndian<quint32>(quint32(packed.size()));
+            entry.rawSize = qToLittleEndian<quint32>(quint32(raw.size()));
+            blockTable.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+
+            rawOffset += block.rawSize;
+            fileOffset += quint64(packed.size());
+        }
+
+        if (!padTo8(file, fileOffset) || file.write(blockTable) != blockTable.size()) {
+            file.cancelWriting();
+            return false;
+        }
+        header.blockTableOffset = qToLittleEndian(align8(fileOffset));
+        header.blockCount = qToLittleEndian<quint64>(quint64(blocks.size()));
+        if (!file.seek(0)
+                || file.write(reinterpret_cast<const char *>(&header), sizeof(header))
+                   != qint64(sizeof(header))) {
+            file.cancelWriting();
+            return false;
+        }
+    }
+
+    return file.commit();
+}
+
+/**
+ * @brief 检查文件是否为二进制快照
+ * @param path 文件路径
+ * @return 文件以魔数 "NPSB" 开头返回 true
+ */
+bool BinarySnapshot::isSnapshotFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return file.read(4) == QByteArray(kMagic, 4);
+}
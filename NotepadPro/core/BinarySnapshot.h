@@ -0,0 +1,95 @@
+/**
+ * @file BinarySnapshot.h
+ * @brief 二进制数据快照（内存映射加载）
+ *
+ * 知识点：
+ * - 定长文件头 + 定长记录表 + 字符串堆的二进制布局
+ * - QFile::map() 内存映射，按需访问而不是 readAll()
+ * - QUuid::toRfc4122() 16 字节二进制 ID，不是 UUID 的 ID 存为字符串
+ * - qToLittleEndian/qFromLittleEndian 固定字节序
+ * - qCompress()/qUncompress() 分块压缩正文，每块可以单独解压
+ */
+
+#ifndef BINARYSNAPSHOT_H
+#define BINARYSNAPSHOT_H
+
+#include <QFile>
+#include <QCache>
+#include <QMutex>
+#include <QList>
+#include <QString>
+#include <QSharedPointer>
+
+#include "NoteRecord.h"
+#include "NoteContentCache.h"
+
+/**
+ * @class BinarySnapshot
+ * @brief 版本化的二进制快照文件
+ *
+ * 文件布局（小端字节序）：
+ * - 64 字节文件头：魔数 "NPSB"、版本号、记录数、各区段偏移
+ * - 笔记表：每条 88 字节，包含二进制 ID、毫秒时间戳、字符串堆引用；
+ *   ID 不是规范形式的 UUID 时（版本 3），ID 字段改存字符串堆引用并在标志位中注明
+ * - 分类表：每条 56 字节
+ * - 字符串堆：UTF-16 文本，记录中只保存（偏移, 长度）
+ * - 压缩快照（版本 2）：正文不放在字符串堆中，而是按顺序拼接后切成约 128 KB 的块，
+ *   每块只包含完整的笔记并单独压缩，文件末尾的块表记录每块的位置；
+ *   读取一条正文只需解压它所在的一个块，解压结果在小缓存中复用
+ *
+ * 打开时只映射文件并校验文件头，记录在访问时才解码。
+ * 由 QSharedPointer 持有时可以作为按需加载的正文数据源，
+ * 只要还有笔记引用它，映射就一直有效
+ */
+class BinarySnapshot : public NoteContentSource,
+                       public QEnableSharedFromThis<BinarySnapshot>
+{
+public:
+    BinarySnapshot();
+    ~BinarySnapshot() override;
+
+    // 打开/关闭
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const;
+
+    // 记录访问
+    int noteCount() const;
+    int categoryCount() const;
+    NoteRecord note(int index, bool withContent = true) const;
+    CategoryRecord category(int index) const;
+
+    // NoteContentSource 接口
+    QString readContent(qint64 offset, qint64 length) const override;
+
+    // 写入与格式检测
+    static bool write(const QString &path, const QList<NoteRecord> &notes,
+                      const QList<CategoryRecord> &categories, bool compressContent = false);
+    static bool isSnapshotFile(const QString &path);
+
+private:
+    Q_DISABLE_COPY(BinarySnapshot)
+
+    QString idString(const uchar *bytes, bool isString) const;
+    QString heapString(quint64 offset, quint64 length) const;
+    QString blockString(quint64 offset, quint64 length) const;
+
+    QFile m_file;
+    const uchar *m_data;
+    qint64 m_size;
+    int m_noteCount;
+    int m_categoryCount;
+    quint64 m_noteTableOffset;
+    quint64 m_categoryTableOffset;
+    quint64 m_heapOffset;
+    quint64 m_heapSize;
+
+    // 压缩正文
+    bool m_compressed;
+    quint64 m_blockTableOffset;
+    int m_blockCount;
+    mutable QMutex m_blockMutex;
+    mutable QCache<int, QByteArray> m_blockCache;
+};
+
+#endif // BINARYSNAPSHOT_H
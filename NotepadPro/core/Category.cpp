@@ -3,7 +3,7 @@
  * @brief 分类数据模型实现
  *
  * 知识点：
- * - QUuid 生成唯一标识符
+ * - NoteId::generate() 生成唯一标识符（随机 UUID，可按 16 字节保存）
  * - QColor 颜色处理
  * - QJsonObject JSON 序列化
  * - 信号槽通知属性变化
@@ -17,7 +17,7 @@
  */
 Category::Category(QObject *parent)
     : QObject(parent)
-    , m_id(QUuid::createUuid().toString(QUuid::WithoutBraces))
+    , m_id(NoteId::generate().toString())
     , m_name(tr("新建分类"))
     , m_color(Qt::blue)
 {
@@ -30,7 +30,7 @@ Category::Category(QObject *parent)
  */
 Category::Category(const QString &name, QObject *parent)
     : QObject(parent)
-    , m_id(QUuid::createUuid().toString(QUuid::WithoutBraces))
+    , m_id(NoteId::generate().toString())
     , m_name(name)
     , m_color(Qt::blue)
 {
@@ -84,21 +84,43 @@ void Category::setParentId(const QString &parentId)
     }
 }
 
+/**
+ * @brief 转换为纯数据记录
+ * @return 分类记录
+ */
+CategoryRecord Category::toRecord() const
+{
+    CategoryRecord record;
+    record.id = m_id;
+    record.name = m_name;
+    record.color = m_color;
+    record.parentId = m_parentId;
+    return record;
+}
+
+/**
+ * @brief 从纯数据记录创建分类
+ * @param record 分类记录
+ * @param parent 父对象指针
+ * @return 新创建的分类对象
+ */
+Category* Category::fromRecord(const CategoryRecord &record, QObject *parent)
+{
+    Category *category = new Category(parent);
+    category->m_id = record.id;
+    category->m_name = record.name;
+    category->m_color = record.color;
+    category->m_parentId = record.parentId;
+    return category;
+}
+
 /**
  * @brief 序列化为 JSON 对象
  * @return JSON 对象
- *
- * 知识点：
- * - QColor::name() 返回 "#RRGGBB" 格式字符串
  */
 QJsonObject Category::toJson() const
 {
-    QJsonObject json;
-    json["id"] = m_id;
-    json["name"] = m_name;
-    json["color"] = m_color.name();
-    json["parentId"] = m_parentId;
-    return json;
+    return toRecord().toJson();
 }
 
 /**
@@ -109,10 +131,5 @@ QJsonObject Category::toJson() const
  */
 Category* Category::fromJson(const QJsonObject &json, QObject *parent)
 {
-    Category *category = new Category(parent);
-    category->m_id = json["id"].toString();
-    category->m_name = json["name"].toString();
-    category->m_color = QColor(json["color"].toString());
-    category->m_parentId = json["parentId"].toString();
-    return category;
+    return fromRecord(CategoryRecord::fromJson(json), parent);
 }
@@ -14,9 +14,11 @@
 #include <QObject>
 #include <QString>
 #include <QColor>
-#include <QUuid>
 #include <QJsonObject>
 
+#include "NoteId.h"
+#include "NoteRecord.h"
+
 /**
  * @class Category
  * @brief 分类数据模型类
@@ -48,6 +50,10 @@ public:
     void setColor(const QColor &color);
     void setParentId(const QString &parentId);
 
+    // 记录转换
+    CategoryRecord toRecord() const;
+    static Category* fromRecord(const CategoryRecord &record, QObject *parent = nullptr);
+
     // JSON 序列化
     QJsonObject toJson() const;
     static Category* fromJson(const QJsonObject &json, QObject *parent = nullptr);
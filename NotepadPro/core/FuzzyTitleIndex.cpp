@@ -0,0 +1,354 @@
+/**
+ * @file FuzzyTitleIndex.cpp
+ * @brief 标题模糊匹配索引实现
+ *
+ * 知识点：
+ * - 近似子串匹配：模式串可以从文本的任意位置开始，动态规划第 0 行全为 0
+ * - 计数数组代替哈希表统计候选的 bigram 命中数，只记录碰到过的文档
+ */
+
+#include "FuzzyTitleIndex.h"
+
+#include <QDataStream>
+#include <QStringList>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace {
+// 完全匹配时的加分：标题以查询开头 > 标题中包含查询
+const double kPrefixBonus = 0.5;
+const double kContainsBonus = 0.25;
+// 匹配质量相同时短标题优先
+const double kShortTitleWeight = 0.1;
+// 分批匹配时每批检查的候选数
+const int kBatchSize = 256;
+
+/**
+ * @brief 查询词允许的编辑次数：短词必须精确，越长越宽松
+ */
+int maxErrorsFor(int length)
+{
+    if (length < 4) {
+        return 0;
+    }
+    return length < 8 ? 1 : 2;
+}
+}
+
+/**
+ * @brief 索引一个标题
+ * @param docId 文档编号（大于所有已索引的编号）
+ * @param title 标题
+ */
+void FuzzyTitleIndex::addDocument(quint32 docId, const QString &title)
+{
+    const QString folded = title.toCaseFolded();
+    const QVector<quint32> bigrams = bigramsOf(folded);
+    for (quint32 bigram : bigrams) {
+        m_bigrams[bigram].append(docId);
+    }
+    m_titles.insert(docId, folded);
+}
+
+/**
+ * @brief 移除一个标题
+ * @param docId 文档编号
+ */
+void FuzzyTitleIndex::removeDocument(quint32 docId)
+{
+    const QString folded = m_titles.take(docId);
+    const QVector<quint32> bigrams = bigramsOf(folded);
+    for (quint32 bigram : bigrams) {
+        auto it = m_bigrams.find(bigram);
+        if (it == m_bigrams.end()) {
+            continue;
+        }
+        PostingList &list = it.value();
+        auto pos = std::lower_bound(list.begin(), list.end(), docId);
+        if (pos != list.end() && *pos == docId) {
+            list.erase(pos);
+        }
+        if (list.isEmpty()) {
+            m_bigrams.erase(it);
+        }
+    }
+}
+
+/**
+ * @brief 清空索引
+ */
+void FuzzyTitleIndex::clear()
+{
+    m_titles.clear();
+    m_bigrams.clear();
+}
+
+/**
+ * @brief 按新旧编号对照表重新编号
+ * @param newIds 旧编号 → 新编号（保持顺序）；不在表中的文档被丢弃
+ */
+void FuzzyTitleIndex::renumber(const QHash<quint32, quint32> &newIds)
+{
+    QHash<quint32, QString> titles;
+    titles.reserve(m_titles.size());
+    for (auto it = m_titles.constBegin(); it != m_titles.constEnd(); ++it) {
+        const auto idIt = newIds.constFind(it.key());
+        if (idIt != newIds.constEnd()) {
+            titles.insert(idIt.value(), it.value());
+        }
+    }
+    m_titles = titles;
+
+    for (auto it = m_bigrams.begin(); it != m_bigrams.end();) {
+        PostingList renumbered;
+        for (quint32 docId : std::as_const(it.value())) {
+            const auto idIt = newIds.constFind(docId);
+            if (idIt != newIds.constEnd()) {
+                renumbered.append(idIt.value());
+            }
+        }
+        if (renumbered.isEmpty()) {
+            it = m_bigrams.erase(it);
+        } else {
+            it.value() = renumbered;
+            ++it;
+        }
+    }
+}
+
+/**
+ * @brief 写出标题和 bigram 索引
+ * @param out 数据流
+ */
+void FuzzyTitleIndex::write(QDataStream &out) const
+{
+    out << m_titles << m_bigrams;
+}
+
+/**
+ * @brief 读入 write() 写出的索引
+ * @param in 数据流（读取失败时由调用方检查流状态）
+ */
+void FuzzyTitleIndex::read(QDataStream &in)
+{
+    in >> m_titles >> m_bigrams;
+}
+
+/**
+ * @brief 模糊匹配标题
+ * @param query 查询文本，空格分隔的词顺序不限
+ * @param onBatch 每检查完一批候选调用一次（批次可能为空），返回 false 取消匹配
+ * @return 匹配完成返回 true，被取消返回 false
+ *
+ * 每个词都必须在标题中近似出现（编辑距离不超过该词允许的次数）。
+ * 匹配质量 = 各词匹配上的字符数之和 / 各词长度之和，
+ * 再按“标题以查询开头”“标题包含查询”和标题长度加分
+ */
+bool FuzzyTitleIndex::match(const QString &query, const BatchCallback &onBatch) const
+{
+    const QString folded = query.toCaseFolded().simplified();
+    const QStringList words = folded.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+    if (words.isEmpty()) {
+        return onBatch(QVector<Match>());
+    }
+
+    QVector<Pattern> patterns;
+    patterns.reserve(words.size());
+    int totalLength = 0;
+    for (const QString &word : words) {
+        patterns.append(compile(word));
+        totalLength += patterns.last().text.size();
+    }
+
+    // 各词候选的交集；词太短无法过滤时不参与
+    PostingList docIds;
+    bool filtered = false;
+    for (const Pattern &pattern : std::as_const(patterns)) {
+        PostingList list;
+        if (!candidates(pattern, &list)) {
+            continue;
+        }
+        if (filtered) {
+            PostingList merged;
+            std::set_intersection(docIds.constBegin(), docIds.constEnd(),
+                                  list.constBegin(), list.constEnd(), std::back_inserter(merged));
+            docIds = merged;
+        } else {
+            docIds = list;
+            filtered = true;
+        }
+    }
+    if (!filtered) {
+        docIds.reserve(m_titles.size());
+        for (auto it = m_titles.constBegin(); it != m_titles.constEnd(); ++it) {
+            docIds.append(it.key());
+        }
+    }
+
+    QVector<Match> batch;
+    for (int i = 0; i < docIds.size(); ++i) {
+        const QString &title = *m_titles.constFind(docIds.at(i));
+        int matched = 0;
+        bool accepted = true;
+        for (const Pattern &pattern : std::as_const(patterns)) {
+            const int errors = distance(pattern, title);
+            if (errors > pattern.maxErrors) {
+                accepted = false;
+                break;
+            }
+            matched += pattern.text.size() - errors;
+        }
+
+        if (accepted) {
+            double score = double(matched) / totalLength;
+            if (title.startsWith(folded)) {
+                score += kPrefixBonus;
+            } else if (title.contains(folded)) {
+                score += kContainsBonus;
+            }
+            score += kShortTitleWeight / (1 + title.size());
+            batch.append(Match{docIds.at(i), score});
+        }
+
+        if ((i + 1) % kBatchSize == 0) {
+            if (!onBatch(batch)) {
+                return false;
+            }
+            batch.clear();
+        }
+    }
+    return onBatch(batch);
+}
+
+/**
+ * @brief 字符在查询词中出现位置的位图（第 i 位对应第 i 个字符）
+ */
+quint64 FuzzyTitleIndex::Pattern::maskOf(QChar ch) const
+{
+    const ushort code = ch.unicode();
+    return code < 128 ? asciiMasks[code] : otherMasks.value(code);
+}
+
+/**
+ * @brief 预处理查询词
+ * @param word 折叠大小写后的词（超过 MaxPatternLength 的部分被截掉）
+ */
+FuzzyTitleIndex::Pattern FuzzyTitleIndex::compile(const QString &word)
+{
+    Pattern pattern;
+    pattern.text = word.left(MaxPatternLength);
+    pattern.maxErrors = maxErrorsFor(pattern.text.size());
+    for (int i = 0; i < pattern.text.size(); ++i) {
+        const ushort code = pattern.text.at(i).unicode();
+        const quint64 bit = quint64(1) << i;
+        if (code < 128) {
+            pattern.asciiMasks[code] |= bit;
+        } else {
+            pattern.otherMasks[code] |= bit;
+        }
+    }
+    return pattern;
+}
+
+/**
+ * @brief 查询词与文本中最接近的子串之间的编辑距离（Myers 位并行算法）
+ * @param pattern 查询词
+ * @param text 文本
+ * @return 最小编辑距离（插入、删除、替换各算一次）
+ *
+ * pv/mv 的第 i 位表示动态规划当前列第 i 行与上一行的差为 +1/-1，
+ * score 跟踪最后一行的值，即以当前字符结尾的最佳匹配
+ */
+int FuzzyTitleIndex::distance(const Pattern &pattern, const QString &text)
+{
+    const int length = pattern.text.size();
+    const quint64 last = quint64(1) << (length - 1);
+    quint64 pv = ~quint64(0);
+    quint64 mv = 0;
+    int score = length;
+    int best = length;
+
+    for (const QChar ch : text) {
+        const quint64 eq = pattern.maskOf(ch);
+        const quint64 xv = eq | mv;
+        const quint64 xh = (((eq & pv) + pv) ^ pv) | eq;
+        quint64 ph = mv | ~(xh | pv);
+        quint64 mh = pv & xh;
+        if (ph & last) {
+            ++score;
+        } else if (mh & last) {
+            --score;
+        }
+        // 匹配可以从任意位置开始，第 0 行恒为 0，移入的最低位为 0
+        ph <<= 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        best = qMin(best, score);
+        if (best == 0) {
+            break;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief 文本中不重复的 bigram（两个 UTF-16 码元打包成 32 位整数）
+ */
+QVector<quint32> FuzzyTitleIndex::bigramsOf(const QString &text)
+{
+    QVector<quint32> bigrams;
+    if (text.size() < 2) {
+        return bigrams;
+    }
+
+    bigrams.reserve(text.size() - 1);
+    const QChar *data = text.constData();
+    for (int i = 0; i + 1 < text.size(); ++i) {
+        bigrams.append((quint32(data[i].unicode()) << 16) | data[i + 1].unicode());
+    }
+    std::sort(bigrams.begin(), bigrams.end());
+    bigrams.erase(std::unique(bigrams.begin(), bigrams.end()), bigrams.end());
+    return bigrams;
+}
+
+/**
+ * @brief 可能与查询词近似匹配的文档
+ * @param pattern 查询词
+ * @param result 输出候选文档编号（有序）
+ * @return 词太短、无法用 bigram 过滤时返回 false（此时全部文档都是候选）
+ *
+ * 每次编辑最多破坏 2 个 bigram，候选至少要包含（不同 bigram 数 - 2 × 允许编辑次数）个
+ */
+bool FuzzyTitleIndex::candidates(const Pattern &pattern, PostingList *result) const
+{
+    const QVector<quint32> bigrams = bigramsOf(pattern.text);
+    const int threshold = bigrams.size() - 2 * pattern.maxErrors;
+    if (threshold <= 0) {
+        return false;
+    }
+
+    // 只为碰到过的文档计数，内存与命中的列表长度成正比，与文档编号的范围无关
+    QHash<quint32, int> counts;
+    for (quint32 bigram : bigrams) {
+        const auto it = m_bigrams.constFind(bigram);
+        if (it == m_bigrams.constEnd()) {
+            continue;
+        }
+        for (quint32 docId : it.value()) {
+            ++counts[docId];
+        }
+    }
+
+    result->clear();
+    for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) {
+        if (it.value() >= threshold) {
+            result->append(it.key());
+        }
+    }
+    std::sort(result->begin(), result->end());
+    return true;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file FuzzyTitleIndex.h
+ * @brief 标题模糊匹配索引
+ *
+ * 知识点：
+ * - q-gram 引理：一次编辑最多破坏查询中的 2 个 bigram，
+ *   编辑距离不超过 k 的标题至少包含查询的（不同 bigram 数 - 2k）个 bigram
+ * - Myers 位并行算法：模式串不超过 64 个字符时，一列动态规划用两个 64 位整数表示，
+ *   每个文本字符只需要十几次位运算
+ * - 先用 bigram 过滤候选，再对候选计算编辑距离
+ */
+
+#ifndef FUZZYTITLEINDEX_H
+#define FUZZYTITLEINDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+class QDataStream;
+
+/**
+ * @class FuzzyTitleIndex
+ * @brief 容错的标题匹配，类似命令面板的“输入几个字母找到文件”
+ *
+ * 查询按空格拆成若干个词，每个词在标题中的某个位置近似出现即可（允许少量拼写错误），
+ * 词的顺序不限。匹配质量由编辑距离决定，完全匹配、标题开头匹配和短标题排在前面。
+ *
+ * 文档编号由调用方（SearchIndex）分配，必须递增
+ */
+class FuzzyTitleIndex
+{
+public:
+    using PostingList = QVector<quint32>;
+
+    /**
+     * @brief 一条匹配
+     */
+    struct Match
+    {
+        quint32 docId;
+        double score;   // 匹配质量，越大越好
+    };
+
+    /// 分批回调：返回 false 取消匹配
+    using BatchCallback = std::function<bool(const QVector<Match> &batch)>;
+
+    /// 参与匹配的查询词最大长度（Myers 算法一个机器字的位数）
+    static constexpr int MaxPatternLength = 64;
+
+    void addDocument(quint32 docId, const QString &title);
+    void removeDocument(quint32 docId);
+    void clear();
+    void renumber(const QHash<quint32, quint32> &newIds);
+
+    bool match(const QString &query, const BatchCallback &onBatch) const;
+
+    // 持久化（由 SearchIndex 调用）
+    void write(QDataStream &out) const;
+    void read(QDataStream &in);
+
+private:
+    /**
+     * @brief 预处理后的查询词
+     */
+    struct Pattern
+    {
+        QString text;                   // 折叠大小写后的词
+        int maxErrors = 0;              // 允许的编辑次数
+        quint64 asciiMasks[128] = {};   // 每个字符在词中出现位置的位图
+        QHash<ushort, quint64> otherMasks;
+
+        quint64 maskOf(QChar ch) const;
+    };
+
+    static Pattern compile(const QString &word);
+    static int distance(const Pattern &pattern, const QString &text);
+    static QVector<quint32> bigramsOf(const QString &text);
+    bool candidates(const Pattern &pattern, PostingList *result) const;
+
+    QHash<quint32, QString> m_titles;       // 文档编号 → 折叠大小写后的标题
+    QHash<quint32, PostingList> m_bigrams;  // bigram → 文档编号
+};
+
+#endif // FUZZYTITLEINDEX_H
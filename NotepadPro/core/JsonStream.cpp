@@ -0,0 +1,318 @@
+/**
+ * @file JsonStream.cpp
+ * @brief 流式读写笔记 JSON 文件实现
+ *
+ * 知识点：
+ * - JSON 的结构字符（{ } [ ] " : ,）都是 ASCII，可以直接在 UTF-8 字节上扫描
+ * - 字符串内部的结构字符和转义序列需要跳过
+ * - QSaveFile 边写边落到临时文件，commit() 时原子替换
+ * - QtConcurrent::run() 并行解析记录批次，按提交顺序取回结果
+ */
+
+#include "JsonStream.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QQueue>
+#include <QThread>
+#include <QtConcurrent>
+
+namespace {
+// 每次读取的块大小
+const qint64 kChunkSize = 256 * 1024;
+// 写入时每隔多少条记录报告一次进度
+const int kProgressInterval = 64;
+// 读取时每批交给工作线程解析的记录数/字节数上限
+const int kBatchRecords = 256;
+const int kBatchBytes = 4 * 1024 * 1024;
+
+/**
+ * @brief 正在扫描的数组
+ */
+enum ArrayKind {
+    OtherArray,
+    NotesArray,
+    CategoriesArray
+};
+
+/**
+ * @brief 一批解析好的记录
+ */
+struct ParsedBatch
+{
+    QList<NoteRecord> notes;
+    QList<CategoryRecord> categories;
+    bool ok = true;
+};
+
+/**
+ * @brief 解析一批记录（在工作线程中执行）
+ * @param records 每条记录的原始 JSON 字节
+ * @param kind 记录所在的数组
+ * @return 解析结果
+ *
+ * 除 JSON 解码外，日期解析和笔记预览（HTML 转纯文本）也在这里完成，
+ * GUI 线程只需要创建对象和连接信号
+ */
+ParsedBatch parseBatch(const QList<QByteArray> &records, ArrayKind kind)
+{
+    ParsedBatch batch;
+    for (const QByteArray &raw : records) {
+        const QJsonDocument doc = QJsonDocument::fromJson(raw);
+        if (!doc.isObject()) {
+            batch.ok = false;
+            break;
+        }
+        if (kind == NotesArray) {
+            NoteRecord note = NoteRecord::fromJson(doc.object());
+            note.preview = NoteRecord::previewFromHtml(note.content);
+            batch.notes.append(note);
+        } else {
+            batch.categories.append(CategoryRecord::fromJson(doc.object()));
+        }
+    }
+    return batch;
+}
+
+/**
+ * @brief 写入一个记录数组
+ * @param file 目标文件
+ * @param name 数组的键名
+ * @param records 记录列表
+ * @param last 是否为最后一个键
+ * @param done 已写入的记录数（累加）
+ * @param total 记录总数
+ * @param progress 进度回调
+ * @return 未被取消返回 true
+ */
+template <typename Record>
+bool writeArray(QSaveFile &file, const char *name, const QList<Record> &records, bool last,
+                qint64 *done, qint64 total, const JsonStream::ProgressCallback &progress)
+{
+    file.write("    \"");
+    file.write(name);
+    file.write("\": [");
+    for (int i = 0; i < records.size(); ++i) {
+        file.write(i == 0 ? "\n        " : ",\n        ");
+        file.write(QJsonDocument(records.at(i).toJson()).toJson(QJsonDocument::Compact));
+        if (++*done % kProgressInterval == 0 && progress && !progress(*done, total)) {
+            return false;
+        }
+    }
+    file.write(records.isEmpty() ? "]" : "\n    ]");
+    file.write(last ? "\n" : ",\n");
+    return true;
+}
+}
+
+/**
+ * @brief 流式读取笔记 JSON 文件
+ * @param path 文件路径
+ * @param onNote 每解析出一条笔记调用一次（在调用线程中，按文件顺序）
+ * @param onCategory 每解析出一个分类调用一次
+ * @param progress 每读完一块调用一次（已读字节数, 文件大小），返回 false 取消
+ * @return 读取结果
+ *
+ * 知识点：
+ * - 只跟踪嵌套深度和字符串状态：深度 1 的键名决定当前数组的含义，
+ *   深度 2 的对象就是一条记录，把它的字节截取出来
+ * - 截取出的记录按批交给线程池并行解析，在途批次数有上限，内存占用不随文件增长
+ */
+JsonStream::Result JsonStream::read(const QString &path, const NoteCallback &onNote,
+                                    const CategoryCallback &onCategory,
+                                    const ProgressCallback &progress)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return Failed;
+    }
+    const qint64 total = file.size();
+
+    int depth = 0;
+    bool started = false;
+    bool inString = false;
+    bool escaped = false;
+    QByteArray lastString;
+    QByteArray key;
+    ArrayKind arrayKind = OtherArray;
+    bool capturing = false;
+    QByteArray record;
+
+    // 待解析的批次和在途的解析任务
+    QList<QByteArray> batch;
+    qint64 batchBytes = 0;
+    QQueue<QFuture<ParsedBatch>> inFlight;
+    const int maxInFlight = qMax(2, QThread::idealThreadCount() * 2);
+
+    auto deliver = [&onNote, &onCategory](const ParsedBatch &parsed) {
+        if (!parsed.ok) {
+            return false;
+        }
+        for (const NoteRecord &note : parsed.notes) {
+            if (onNote) {
+                onNote(note);
+            }
+        }
+        for (const CategoryRecord &category : parsed.categories) {
+            if (onCategory) {
+                onCategory(category);
+            }
+        }
+        return true;
+    };
+    auto submit = [&]() {
+        if (!batch.isEmpty()) {
+            inFlight.enqueue(QtConcurrent::run(parseBatch, batch, arrayKind));
+            batch.clear();
+            batchBytes = 0;
+        }
+        while (inFlight.size() > maxInFlight) {
+            if (!deliver(inFlight.dequeue().result())) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    while (!file.atEnd()) {
+        const QByteArray chunk = file.read(kChunkSize);
+        if (chunk.isEmpty()) {
+            return Failed;
+        }
+        const char *data = chunk.constData();
+        int captureStart = 0;
+
+        for (int i = 0; i < chunk.size(); ++i) {
+            const char c = data[i];
+            if (inString) {
+                if (escaped) {
+                    escaped = false;
+                } else if (c == '\\') {
+                    escaped = true;
+                } else if (c == '"') {
+                    inString = false;
+                    continue;
+                }
+                if (depth == 1) {
+                    lastString += c;
+                }
+                continue;
+            }
+
+            switch (c) {
+            case '"':
+                inString = true;
+                if (depth == 1) {
+                    lastString.clear();
+                }
+                break;
+            case ':':
+                if (depth == 1) {
+                    key = lastString;
+                }
+                break;
+            case '{':
+            case '[':
+                if (depth == 0 && (c != '{' || started)) {
+                    return Failed;
+                }
+                if (depth == 1 && c == '[') {
+                    arrayKind = key == "notes" ? NotesArray
+                              : key == "categories" ? CategoriesArray : OtherArray;
+                }
+                if (depth == 2 && c == '{' && arrayKind != OtherArray) {
+                    capturing = true;
+                    captureStart = i;
+                    record.clear();
+                }
+                started = true;
+                ++depth;
+                break;
+            case '}':
+            case ']':
+                if (depth == 0) {
+                    return Failed;
+                }
+                --depth;
+                if (depth == 2 && capturing) {
+                    record.append(data + captureStart, i + 1 - captureStart);
+                    capturing = false;
+                    batch.append(record);
+                    batchBytes += record.size();
+                    if ((batch.size() >= kBatchRecords || batchBytes >= kBatchBytes) && !submit()) {
+                        return Failed;
+                    }
+                }
+                // 数组结束时提交剩余记录，保证一个批次只含一种记录
+                if (depth == 1) {
+                    if (!submit()) {
+                        return Failed;
+                    }
+                    arrayKind = OtherArray;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        // 记录跨越数据块边界时，先保存本块中的部分
+        if (capturing) {
+            record.append(data + captureStart, chunk.size() - captureStart);
+        }
+        if (progress && !progress(file.pos(), total)) {
+            return Canceled;
+        }
+    }
+
+    if (!started || depth != 0 || inString) {
+        return Failed;
+    }
+    while (!inFlight.isEmpty()) {
+        if (!deliver(inFlight.dequeue().result())) {
+            return Failed;
+        }
+    }
+    return Ok;
+}
+
+/**
+ * @brief 流式写入笔记 JSON 文件
+ * @param path 文件路径
+ * @param notes 笔记记录
+ * @param categories 分类记录
+ * @param progress 进度回调（已写入记录数, 记录总数），返回 false 取消
+ * @return 写入结果
+ *
+ * 每条记录单独序列化后立即写出，不构造整个文档；
+ * 按需加载的正文也是逐条读取，写完即释放。不访问任何 QObject，可以在工作线程中调用
+ */
+JsonStream::Result JsonStream::write(const QString &path, const QList<NoteRecord> &notes,
+                                     const QList<CategoryRecord> &categories,
+                                     const ProgressCallback &progress)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return Failed;
+    }
+
+    const qint64 total = notes.size() + categories.size();
+    qint64 done = 0;
+    file.write("{\n");
+    if (!writeArray(file, "notes", notes, false, &done, total, progress)
+            || !writeArray(file, "categories", categories, true, &done, total, progress)) {
+        file.cancelWriting();
+        return Canceled;
+    }
+    file.write("}\n");
+
+    if (!file.commit()) {
+        return Failed;
+    }
+    if (progress) {
+        progress(total, total);
+    }
+    return Ok;
+}
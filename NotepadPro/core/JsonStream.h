@@ -0,0 +1,55 @@
+/**
+ * @file JsonStream.h
+ * @brief 流式读写笔记 JSON 文件
+ *
+ * 知识点：
+ * - 分块读取文件，用简单的状态机找出每条记录的字节范围
+ * - 每次只把一条记录交给 QJsonDocument 解析，内存占用与文件大小无关
+ * - 记录分批在线程池中并行解析（QtConcurrent）
+ * - std::function 回调报告进度并支持取消
+ */
+
+#ifndef JSONSTREAM_H
+#define JSONSTREAM_H
+
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+#include "NoteRecord.h"
+
+/**
+ * @class JsonStream
+ * @brief notes/categories JSON 格式的流式读写
+ *
+ * 文件格式与 QJsonDocument 整体读写的格式相同：
+ * {"notes": [{...}, ...], "categories": [{...}, ...]}
+ * 因此新旧文件可以互相读取
+ */
+class JsonStream
+{
+public:
+    /**
+     * @brief 读写结果
+     */
+    enum Result {
+        Ok,         ///< 成功
+        Failed,     ///< 无法打开、格式错误或写入失败
+        Canceled    ///< 被进度回调取消
+    };
+
+    /// 进度回调：已处理字节数/记录数与总数，返回 false 取消操作
+    using ProgressCallback = std::function<bool(qint64 done, qint64 total)>;
+    using NoteCallback = std::function<void(const NoteRecord &note)>;
+    using CategoryCallback = std::function<void(const CategoryRecord &category)>;
+
+    static Result read(const QString &path, const NoteCallback &onNote,
+                       const CategoryCallback &onCategory,
+                       const ProgressCallback &progress = ProgressCallback());
+    static Result write(const QString &path, const QList<NoteRecord> &notes,
+                        const QList<CategoryRecord> &categories,
+                        const ProgressCallback &progress = ProgressCallback());
+};
+
+#endif // JSONSTREAM_H
@@ -1,12 +1,12 @@
 /**
  * @file Note.h
- * @brief 笔记数据模型
+ * @brief 笔记句柄
  *
  * 知识点：
  * - Q_OBJECT 宏和元对象系统
  * - Q_PROPERTY 属性系统
  * - 自定义信号
- * - QDateTime 时间处理
+ * - 句柄模式：对象只保存ID，数据留在 NoteManager 的笔记表中
  */
 
 #ifndef NOTE_H
@@ -15,14 +15,19 @@
 #include <QObject>
 #include <QString>
 #include <QDateTime>
-#include <QUuid>
 #include <QJsonObject>
 
+#include "NoteManager.h"
+#include "NoteRecord.h"
+
 /**
  * @class Note
- * @brief 笔记数据模型类
+ * @brief 正在编辑的笔记的句柄
  *
- * 存储单个笔记的所有信息，包括标题、内容、分类、时间戳等
+ * 笔记数据以值的形式保存在 NoteManager 的 NoteTable 中，不再为每条笔记创建 QObject。
+ * 只有需要属性绑定和逐字段信号的地方（编辑器中打开的笔记）才通过
+ * NoteManager::openNote() 拿到句柄；读写都转发给 NoteManager，
+ * 修改经 NoteManager 更新时间戳、标记脏记录并发出 notesModified()
  */
 class Note : public QObject
 {
@@ -37,9 +42,6 @@ class Note : public QObject
     Q_PROPERTY(bool isPinned READ isPinned WRITE setPinned NOTIFY isPinnedChanged)
 
 public:
-    explicit Note(QObject *parent = nullptr);
-    explicit Note(const QString &title, const QString &content = QString(),
-                  QObject *parent = nullptr);
     ~Note() override = default;
 
     // Getter 方法
@@ -57,12 +59,16 @@ public:
     void setCategoryId(const QString &categoryId);
     void setPinned(bool pinned);
 
-    // JSON 序列化
+    // 按需加载
+    bool isContentLoaded() const;
+
+    // 记录转换
+    NoteRecord toRecord() const;
     QJsonObject toJson() const;
-    static Note* fromJson(const QJsonObject &json, QObject *parent = nullptr);
 
     // 辅助方法
-    QString preview(int maxLength = 100) const;
+    QString plainText() const;
+    QString preview(int maxLength = NoteRecord::PreviewLength) const;
     bool containsText(const QString &text, Qt::CaseSensitivity cs = Qt::CaseInsensitive) const;
 
 signals:
@@ -74,15 +80,13 @@ signals:
     void noteModified();
 
 private:
-    void updateTimestamp();
+    friend class NoteManager;
+
+    Note(NoteManager *manager, const QString &id);
+    void notifyChanged(NoteManager::NoteFields fields);
 
+    NoteManager *m_manager;
     QString m_id;
-    QString m_title;
-    QString m_content;
-    QString m_categoryId;
-    QDateTime m_createdAt;
-    QDateTime m_updatedAt;
-    bool m_isPinned;
 };
 
 #endif // NOTE_H
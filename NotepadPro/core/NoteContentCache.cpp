@@ -0,0 +1,100 @@
+/**
+ * @file NoteContentCache.cpp
+ * @brief 笔记正文 LRU 缓存实现
+ *
+ * 知识点：
+ * - QCache::object() 命中时把条目移到最近使用位置
+ * - QCache::insert() 超出总代价时自动淘汰最久未使用的条目
+ * - 函数内静态局部变量实现线程安全的单例初始化
+ */
+
+#include "NoteContentCache.h"
+
+namespace {
+// 默认缓存 32 MB 正文
+const qint64 kDefaultCapacity = 32 * 1024 * 1024;
+}
+
+/**
+ * @brief 获取单例实例
+ * @return 缓存单例指针
+ */
+NoteContentCache* NoteContentCache::instance()
+{
+    static NoteContentCache cache;
+    return &cache;
+}
+
+/**
+ * @brief 构造函数（私有）
+ */
+NoteContentCache::NoteContentCache()
+{
+    m_cache.setMaxCost(kDefaultCapacity);
+}
+
+/**
+ * @brief 获取笔记正文，未命中时从数据源读取并放入缓存
+ * @param noteId 笔记ID
+ * @param ref 正文在磁盘上的位置
+ * @return 正文文本
+ *
+ * 代价按 UTF-16 字节数计算；单条正文超过容量时不缓存，直接返回
+ */
+QString NoteContentCache::content(const QString &noteId, const NoteContentRef &ref)
+{
+    if (QString *cached = m_cache.object(noteId)) {
+        return *cached;
+    }
+
+    QString text = ref.load();
+    insert(noteId, text);
+    return text;
+}
+
+/**
+ * @brief 放入一条正文（后台预取的结果）
+ * @param noteId 笔记ID
+ * @param text 正文文本
+ */
+void NoteContentCache::insert(const QString &noteId, const QString &text)
+{
+    m_cache.insert(noteId, new QString(text), qMax<qint64>(1, text.size() * 2));
+}
+
+/**
+ * @brief 是否已缓存某条笔记的正文
+ * @param noteId 笔记ID
+ * @return 已缓存返回 true
+ */
+bool NoteContentCache::contains(const QString &noteId) const
+{
+    return m_cache.contains(noteId);
+}
+
+/**
+ * @brief 移除某条笔记的缓存（正文被修改或笔记被删除时）
+ * @param noteId 笔记ID
+ */
+void NoteContentCache::remove(const QString &noteId)
+{
+    m_cache.remove(noteId);
+}
+
+/**
+ * @brief 清空缓存（重新加载数据时）
+ */
+void NoteContentCache::clear()
+{
+    m_cache.clear();
+}
+
+qint64 NoteContentCache::capacity() const
+{
+    return m_cache.maxCost();
+}
+
+void NoteContentCache::setCapacity(qint64 bytes)
+{
+    m_cache.setMaxCost(bytes);
+}
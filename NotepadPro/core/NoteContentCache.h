@@ -0,0 +1,80 @@
+/**
+ * @file NoteContentCache.h
+ * @brief 笔记正文按需加载与 LRU 缓存
+ *
+ * 知识点：
+ * - 纯虚接口（抽象类）描述“正文从哪里读”
+ * - QSharedPointer 共享数据源的生命周期
+ * - QCache 按代价（字节数）限制容量的 LRU 缓存
+ */
+
+#ifndef NOTECONTENTCACHE_H
+#define NOTECONTENTCACHE_H
+
+#include <QCache>
+#include <QSharedPointer>
+#include <QString>
+
+/**
+ * @class NoteContentSource
+ * @brief 笔记正文数据源接口
+ *
+ * 实现类必须是只读且线程安全的，后台保存线程也会通过它读取正文
+ */
+class NoteContentSource
+{
+public:
+    virtual ~NoteContentSource() = default;
+
+    /**
+     * @brief 读取一段正文
+     * @param offset 数据源内部的位置
+     * @param length 正文长度（UTF-16 码元数）
+     * @return 正文文本
+     */
+    virtual QString readContent(qint64 offset, qint64 length) const = 0;
+};
+
+/**
+ * @struct NoteContentRef
+ * @brief 指向磁盘上尚未加载的笔记正文
+ */
+struct NoteContentRef
+{
+    QSharedPointer<const NoteContentSource> source;
+    qint64 offset = 0;
+    qint64 length = 0;
+
+    bool isValid() const { return !source.isNull(); }
+    QString load() const { return source ? source->readContent(offset, length) : QString(); }
+};
+
+/**
+ * @class NoteContentCache
+ * @brief 已加载正文的 LRU 缓存（单例，仅在 GUI 线程使用）
+ *
+ * 常驻内存的正文总量受容量限制，随“最近打开的笔记”而不是笔记总数增长
+ */
+class NoteContentCache
+{
+public:
+    static NoteContentCache* instance();
+
+    QString content(const QString &noteId, const NoteContentRef &ref);
+    void insert(const QString &noteId, const QString &text);
+    bool contains(const QString &noteId) const;
+    void remove(const QString &noteId);
+    void clear();
+
+    // 容量（字节）
+    qint64 capacity() const;
+    void setCapacity(qint64 bytes);
+
+private:
+    NoteContentCache();
+    Q_DISABLE_COPY(NoteContentCache)
+
+    QCache<QString, QString> m_cache;
+};
+
+#endif // NOTECONTENTCACHE_H
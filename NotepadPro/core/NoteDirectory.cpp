@@ -0,0 +1,290 @@
+/**
+ * @file NoteDirectory.cpp
+ * @brief 分片目录存储实现
+ *
+ * 知识点：
+ * - QDir::mkpath() 创建目录，QDir::entryList() 列出文件
+ * - QByteArray::toPercentEncoding() 把任意 ID 转成安全的文件名
+ * - 先写正文文件、再写清单、最后删除旧文件，任一步中断都不会丢失已保存的数据
+ */
+
+#include "NoteDirectory.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+namespace {
+const char kManifestFile[] = "manifest.json";
+const char kCategoriesFile[] = "categories.json";
+const char kNotesDir[] = "notes";
+const char kNoteSuffix[] = ".html";
+const int kManifestVersion = 1;
+
+/**
+ * @brief 原子地写入一个 JSON 文件
+ */
+bool writeJson(const QString &path, const QJsonObject &root)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+/**
+ * @brief 读取一个 JSON 文件的根对象
+ */
+bool readJson(const QString &path, QJsonObject *root)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject()) {
+        return false;
+    }
+    *root = doc.object();
+    return true;
+}
+}
+
+/**
+ * @brief 构造函数
+ * @param path 数据目录路径
+ */
+NoteDirectory::NoteDirectory(const QString &path)
+    : m_path(QDir::cleanPath(path))
+{
+}
+
+/**
+ * @brief 获取数据目录路径
+ * @return 规范化后的目录路径
+ */
+QString NoteDirectory::path() const
+{
+    return m_path;
+}
+
+/**
+ * @brief 读取清单和分类
+ * @param notes 输出笔记记录
+ * @param categories 输出分类记录
+ * @param lazyContent 为 true 时不读取正文，记录中只保存正文位置
+ * @return 读取成功返回 true
+ */
+bool NoteDirectory::load(QList<NoteRecord> *notes, QList<CategoryRecord> *categories,
+                         bool lazyContent)
+{
+    QJsonObject manifest;
+    if (!readJson(m_path + '/' + kManifestFile, &manifest)
+            || manifest["version"].toInt() > kManifestVersion) {
+        return false;
+    }
+
+    const QJsonArray notesArray = manifest["notes"].toArray();
+    m_ids.clear();
+    m_ids.reserve(notesArray.size());
+    notes->reserve(notes->size() + notesArray.size());
+    for (const QJsonValue &val : notesArray) {
+        const QJsonObject entry = val.toObject();
+        NoteRecord record = NoteRecord::fromJson(entry);
+        const qint64 index = m_ids.size();
+        const qint64 length = qint64(entry["contentLength"].toDouble());
+        m_ids.append(record.id);
+
+        if (lazyContent) {
+            record.contentRef.source = sharedFromThis();
+            record.contentRef.offset = index;
+            record.contentRef.length = length;
+        } else {
+            record.content = readContent(index, length);
+        }
+        notes->append(record);
+    }
+
+    QJsonObject categoriesRoot;
+    if (readJson(m_path + '/' + kCategoriesFile, &categoriesRoot)) {
+        const QJsonArray categoriesArray = categoriesRoot["categories"].toArray();
+        for (const QJsonValue &val : categoriesArray) {
+            categories->append(CategoryRecord::fromJson(val.toObject()));
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 读取一条笔记的正文
+ * @param offset 笔记在清单中的序号
+ * @param length 正文长度（仅作提示，以文件实际内容为准）
+ * @return 正文文本；文件不存在时返回空字符串
+ */
+QString NoteDirectory::readContent(qint64 offset, qint64 length) const
+{
+    Q_UNUSED(length)
+    if (offset < 0 || offset >= m_ids.size()) {
+        return QString();
+    }
+
+    QFile file(noteFilePath(m_path, m_ids.at(int(offset))));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    return QString::fromUtf8(file.readAll());
+}
+
+/**
+ * @brief 写出完整数据目录
+ * @param path 目录路径
+ * @param notes 全部笔记记录
+ * @param categories 全部分类记录
+ * @return 写入成功返回 true
+ *
+ * 写完后删除清单中已不存在的笔记文件
+ */
+bool NoteDirectory::write(const QString &path, const QList<NoteRecord> &notes,
+                          const QList<CategoryRecord> &categories)
+{
+    QDir dir(path);
+    if (!dir.mkpath(kNotesDir)) {
+        return false;
+    }
+
+    QSet<QString> fileNames;
+    for (const NoteRecord &note : notes) {
+        if (!writeNoteFile(path, note)) {
+            return false;
+        }
+        fileNames.insert(QFileInfo(noteFilePath(path, note.id)).fileName());
+    }
+    if (!writeIndexFiles(path, notes, categories)) {
+        return false;
+    }
+
+    QDir notesDir(dir.filePath(kNotesDir));
+    const QStringList existing = notesDir.entryList({QString("*") + kNoteSuffix}, QDir::Files);
+    for (const QString &name : existing) {
+        if (!fileNames.contains(name)) {
+            notesDir.remove(name);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 增量写入：只重写变化的笔记文件
+ * @param path 目录路径
+ * @param notes 全部笔记记录（用于生成清单，正文不会被读取）
+ * @param changedIds 新建或修改过的笔记ID
+ * @param removedIds 已删除的笔记ID
+ * @param categories 全部分类记录
+ * @return 写入成功返回 true
+ *
+ * 写入量与修改的笔记数成正比，另加一份只含元数据的清单
+ */
+bool NoteDirectory::writeChanges(const QString &path, const QList<NoteRecord> &notes,
+                                 const QSet<QString> &changedIds, const QSet<QString> &removedIds,
+                                 const QList<CategoryRecord> &categories)
+{
+    if (!QDir(path).mkpath(kNotesDir)) {
+        return false;
+    }
+
+    for (const NoteRecord &note : notes) {
+        if (changedIds.contains(note.id) && !writeNoteFile(path, note)) {
+            return false;
+        }
+    }
+    if (!writeIndexFiles(path, notes, categories)) {
+        return false;
+    }
+    for (const QString &id : removedIds) {
+        QFile::remove(noteFilePath(path, id));
+    }
+    return true;
+}
+
+/**
+ * @brief 判断路径是否为数据目录（包含清单文件）
+ * @param path 路径
+ * @return 是数据目录返回 true
+ */
+bool NoteDirectory::isNoteDirectory(const QString &path)
+{
+    return QFileInfo(path).isDir() && QFile::exists(path + '/' + kManifestFile);
+}
+
+/**
+ * @brief 笔记正文文件路径
+ *
+ * ID 经过百分号编码，导入数据中的任意 ID 都不会越出 notes 目录
+ */
+QString NoteDirectory::noteFilePath(const QString &path, const QString &id)
+{
+    return path + '/' + kNotesDir + '/'
+            + QString::fromLatin1(id.toUtf8().toPercentEncoding()) + kNoteSuffix;
+}
+
+/**
+ * @brief 写入一条笔记的正文文件
+ *
+ * 正文仍引用同一目录中的文件（未加载、未修改）时，文件已是最新，直接跳过
+ */
+bool NoteDirectory::writeNoteFile(const QString &path, const NoteRecord &note)
+{
+    if (note.contentRef.isValid()) {
+        const auto *source = dynamic_cast<const NoteDirectory*>(note.contentRef.source.data());
+        if (source && source->path() == QDir::cleanPath(path)) {
+            return true;
+        }
+    }
+
+    QSaveFile file(noteFilePath(path, note.id));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(note.loadContent().toUtf8());
+    return file.commit();
+}
+
+/**
+ * @brief 写入清单和分类文件
+ */
+bool NoteDirectory::writeIndexFiles(const QString &path, const QList<NoteRecord> &notes,
+                                    const QList<CategoryRecord> &categories)
+{
+    QJsonArray categoriesArray;
+    for (const CategoryRecord &cat : categories) {
+        categoriesArray.append(cat.toJson());
+    }
+    QJsonObject categoriesRoot;
+    categoriesRoot["categories"] = categoriesArray;
+    if (!writeJson(path + '/' + kCategoriesFile, categoriesRoot)) {
+        return false;
+    }
+
+    QJsonArray notesArray;
+    for (const NoteRecord &note : notes) {
+        QJsonObject entry;
+        entry["id"] = note.id;
+        entry["title"] = note.title;
+        entry["categoryId"] = note.categoryId;
+        entry["createdAt"] = note.createdAt.toString(Qt::ISODate);
+        entry["updatedAt"] = note.updatedAt.toString(Qt::ISODate);
+        entry["isPinned"] = note.isPinned;
+        entry["contentLength"] = double(note.contentSize());
+        notesArray.append(entry);
+    }
+    QJsonObject manifest;
+    manifest["version"] = kManifestVersion;
+    manifest["notes"] = notesArray;
+    return writeJson(path + '/' + kManifestFile, manifest);
+}
@@ -0,0 +1,69 @@
+/**
+ * @file NoteDirectory.h
+ * @brief 分片目录存储：每条笔记一个文件 + 清单
+ *
+ * 知识点：
+ * - 把元数据（清单）与正文（单独文件）分开存放
+ * - QSaveFile 逐个文件原子替换
+ * - QEnableSharedFromThis 让数据源把自身交给按需加载的笔记
+ */
+
+#ifndef NOTEDIRECTORY_H
+#define NOTEDIRECTORY_H
+
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QSharedPointer>
+
+#include "NoteRecord.h"
+#include "NoteContentCache.h"
+
+/**
+ * @class NoteDirectory
+ * @brief 目录形式的数据存储
+ *
+ * 目录布局：
+ * - manifest.json：全部笔记的标题、分类、时间戳、置顶状态和正文长度
+ * - categories.json：全部分类
+ * - notes/<id>.html：每条笔记的正文（UTF-8）
+ *
+ * 加载时只读取清单，正文在打开笔记时（或由后台预取）读取；
+ * 保存时只重写变化的笔记文件和清单，一次写入失败最多影响一条笔记
+ */
+class NoteDirectory : public NoteContentSource,
+                      public QEnableSharedFromThis<NoteDirectory>
+{
+public:
+    explicit NoteDirectory(const QString &path);
+
+    QString path() const;
+
+    // 读取（需要由 QSharedPointer 持有，按需加载的笔记会引用它）
+    bool load(QList<NoteRecord> *notes, QList<CategoryRecord> *categories, bool lazyContent);
+
+    // NoteContentSource 接口：offset 为笔记在清单中的序号
+    QString readContent(qint64 offset, qint64 length) const override;
+
+    // 写入
+    static bool write(const QString &path, const QList<NoteRecord> &notes,
+                      const QList<CategoryRecord> &categories);
+    static bool writeChanges(const QString &path, const QList<NoteRecord> &notes,
+                             const QSet<QString> &changedIds, const QSet<QString> &removedIds,
+                             const QList<CategoryRecord> &categories);
+    static bool isNoteDirectory(const QString &path);
+
+private:
+    Q_DISABLE_COPY(NoteDirectory)
+
+    static QString noteFilePath(const QString &path, const QString &id);
+    static bool writeNoteFile(const QString &path, const NoteRecord &note);
+    static bool writeIndexFiles(const QString &path, const QList<NoteRecord> &notes,
+                                const QList<CategoryRecord> &categories);
+
+    QString m_path;
+    QStringList m_ids;
+};
+
+#endif // NOTEDIRECTORY_H
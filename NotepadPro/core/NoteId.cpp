@@ -0,0 +1,171 @@
+/**
+ * @file NoteId.cpp
+ * @brief 128 位二进制ID实现
+ *
+ * 知识点：
+ * - 手工解析/格式化 8-4-4-4-12 形式的十六进制，不经过 QUuid，查找时没有堆分配
+ * - 字符串必须能原样还原（小写、无花括号），否则按非 UUID 的ID登记
+ * - QMutex 保护登记表：工作线程也可能转换ID
+ */
+
+#include "NoteId.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QUuid>
+
+namespace {
+// UUID 字符串的长度和连字符位置
+const int kUuidLength = 36;
+const char kHexDigits[] = "0123456789abcdef";
+
+/**
+ * @brief UUID 字符串的第 i 个字符是否为连字符
+ */
+bool isHyphenPosition(int i)
+{
+    return i == 8 || i == 13 || i == 18 || i == 23;
+}
+
+/**
+ * @brief 非 UUID 的ID登记表：字符串 ↔ 序号
+ */
+struct ForeignIds
+{
+    QMutex mutex;
+    QHash<QString, quint64> indexes;
+    QStringList texts;
+};
+
+ForeignIds &foreignIds()
+{
+    static ForeignIds ids;
+    return ids;
+}
+
+/**
+ * @brief 把能原样还原的 UUID 字符串转换为二进制ID
+ * @return 不是这种字符串（或首 8 字节为 0）时返回空ID
+ */
+NoteId parseUuid(const QString &text)
+{
+    if (text.size() != kUuidLength) {
+        return NoteId();
+    }
+
+    NoteId id;
+    int digits = 0;
+    for (int i = 0; i < kUuidLength; ++i) {
+        const ushort ch = text.at(i).unicode();
+        if (isHyphenPosition(i)) {
+            if (ch != '-') {
+                return NoteId();
+            }
+            continue;
+        }
+        quint64 nibble;
+        if (ch >= '0' && ch <= '9') {
+            nibble = ch - '0';
+        } else if (ch >= 'a' && ch <= 'f') {
+            nibble = ch - 'a' + 10;
+        } else {
+            return NoteId();    // 大写或非十六进制字符无法原样还原
+        }
+        quint64 &half = digits < 16 ? id.hi : id.lo;
+        half = (half << 4) | nibble;
+        ++digits;
+    }
+    // hi 为 0 的空间留给登记表
+    return id.hi != 0 ? id : NoteId();
+}
+}
+
+/**
+ * @brief 生成新的随机ID
+ */
+NoteId NoteId::generate()
+{
+    NoteId id;
+    do {
+        id = parseUuid(QUuid::createUuid().toString(QUuid::WithoutBraces));
+    } while (id.isNull());
+    return id;
+}
+
+/**
+ * @brief 字符串转换为ID，非 UUID 的字符串登记后返回
+ * @param text ID字符串（为空时返回空ID）
+ */
+NoteId NoteId::fromString(const QString &text)
+{
+    if (text.isEmpty()) {
+        return NoteId();
+    }
+    NoteId id = parseUuid(text);
+    if (!id.isNull()) {
+        return id;
+    }
+
+    ForeignIds &ids = foreignIds();
+    QMutexLocker locker(&ids.mutex);
+    auto it = ids.indexes.constFind(text);
+    if (it == ids.indexes.constEnd()) {
+        it = ids.indexes.insert(text, quint64(ids.texts.size()));
+        ids.texts.append(text);
+    }
+    id.lo = it.value() + 1;
+    return id;
+}
+
+/**
+ * @brief 字符串转换为ID，但不登记新的非 UUID 字符串
+ * @param text ID字符串
+ * @return 从未出现过的非 UUID 字符串返回空ID（查找时用，不会让登记表增长）
+ */
+NoteId NoteId::find(const QString &text)
+{
+    NoteId id = parseUuid(text);
+    if (!id.isNull() || text.isEmpty()) {
+        return id;
+    }
+
+    ForeignIds &ids = foreignIds();
+    QMutexLocker locker(&ids.mutex);
+    const auto it = ids.indexes.constFind(text);
+    if (it != ids.indexes.constEnd()) {
+        id.lo = it.value() + 1;
+    }
+    return id;
+}
+
+/**
+ * @brief 转换回字符串（与 fromString() 的输入完全相同）
+ */
+QString NoteId::toString() const
+{
+    if (isNull()) {
+        return QString();
+    }
+    if (hi == 0) {
+        ForeignIds &ids = foreignIds();
+        QMutexLocker locker(&ids.mutex);
+        return ids.texts.value(int(lo - 1));
+    }
+
+    QString text(kUuidLength, Qt::Uninitialized);
+    QChar *out = text.data();
+    int digit = 0;
+    for (int i = 0; i < kUuidLength; ++i) {
+        if (isHyphenPosition(i)) {
+            out[i] = QLatin1Char('-');
+            continue;
+        }
+        const quint64 half = digit < 16 ? hi : lo;
+        const int shift = (15 - digit % 16) * 4;
+        out[i] = QLatin1Char(kHexDigits[(half >> shift) & 0xf]);
+        ++digit;
+    }
+    return text;
+}
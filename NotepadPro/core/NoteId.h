@@ -0,0 +1,206 @@
+/**
+ * @file NoteId.h
+ * @brief 128 位二进制笔记/分类ID 与开放寻址哈希表
+ *
+ * 知识点：
+ * - UUID 本身就是 16 字节，字符串形式（36 个 UTF-16 字符 + 堆上的头部）是它的 5 倍多
+ * - 比较两个ID只是两次 64 位整数比较，不必逐字符比较
+ * - 开放寻址 + 线性探测：键值直接放在连续数组中，没有逐个节点的堆分配，缓存友好
+ * - 删除时把后面同一探测链上的元素往回移（backward shift），不需要墓碑标记
+ */
+
+#ifndef NOTEID_H
+#define NOTEID_H
+
+#include <QString>
+#include <QVector>
+
+#include <utility>
+
+/**
+ * @struct NoteId
+ * @brief 笔记或分类的ID（16 字节）
+ *
+ * 新建的笔记和分类都使用随机 UUID，直接按二进制保存；
+ * 导入数据中不是 UUID 的ID（或首 8 字节为 0 的 UUID）登记在一张进程内的表中，
+ * 用 hi = 0、lo = 表中序号 + 1 表示，仍然能原样转换回字符串。
+ * 字符串形式只在 JSON、存储后端和界面这些边界上使用
+ */
+struct NoteId
+{
+    quint64 hi = 0;
+    quint64 lo = 0;
+
+    static NoteId generate();
+    static NoteId fromString(const QString &text);
+    static NoteId find(const QString &text);
+    QString toString() const;
+
+    bool isNull() const { return hi == 0 && lo == 0; }
+    bool operator==(const NoteId &other) const { return hi == other.hi && lo == other.lo; }
+    bool operator!=(const NoteId &other) const { return !(*this == other); }
+    bool operator<(const NoteId &other) const
+    {
+        return hi != other.hi ? hi < other.hi : lo < other.lo;
+    }
+
+    /// 哈希值：UUID 的位已经是随机的，再混合一次以照顾登记表中的小序号
+    quint64 hash() const
+    {
+        quint64 x = hi ^ (lo * 0x9e3779b97f4a7c15ULL);
+        x ^= x >> 31;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        return x ^ (x >> 29);
+    }
+};
+
+/**
+ * @class NoteIdHash
+ * @brief 以 NoteId 为键的开放寻址哈希表
+ *
+ * 容量是 2 的幂，装载因子不超过 1/2；空槽用空ID表示（空ID不能作为键）
+ */
+template <typename T>
+class NoteIdHash
+{
+public:
+    NoteIdHash() = default;
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    /**
+     * @brief 清空（保留已分配的容量）
+     */
+    void clear()
+    {
+        m_keys.fill(NoteId());
+        m_values.fill(T());
+        m_size = 0;
+    }
+
+    /**
+     * @brief 预留空间，插入 size 个键之前不会重新散列
+     */
+    void reserve(int size)
+    {
+        int capacity = 16;
+        while (capacity < size * 2) {
+            capacity *= 2;
+        }
+        if (capacity > m_keys.size()) {
+            rehash(capacity);
+        }
+    }
+
+    bool contains(const NoteId &key) const { return slotOf(key) >= 0; }
+
+    /**
+     * @brief 查找
+     * @return 键不存在时返回 defaultValue
+     */
+    T value(const NoteId &key, const T &defaultValue = T()) const
+    {
+        const int slot = slotOf(key);
+        return slot >= 0 ? m_values.at(slot) : defaultValue;
+    }
+
+    /**
+     * @brief 插入或覆盖
+     *
+     * 空ID用来标记空槽，不能作为键：调试版断言，发布版忽略这次插入
+     */
+    void insert(const NoteId &key, const T &value)
+    {
+        Q_ASSERT(!key.isNull());
+        if (key.isNull()) {
+            return;
+        }
+        if ((m_size + 1) * 2 > m_keys.size()) {
+            rehash(qMax(16, m_keys.size() * 2));
+        }
+        const int mask = m_keys.size() - 1;
+        int slot = int(key.hash()) & mask;
+        while (!m_keys.at(slot).isNull()) {
+            if (m_keys.at(slot) == key) {
+                m_values[slot] = value;
+                return;
+            }
+            slot = (slot + 1) & mask;
+        }
+        m_keys[slot] = key;
+        m_values[slot] = value;
+        ++m_size;
+    }
+
+    /**
+     * @brief 删除
+     * @return 键存在返回 true
+     *
+     * 空出的槽之后、探测起点不在 (空槽, 当前位置] 之间的元素往回移，保持探测链连续
+     */
+    bool remove(const NoteId &key)
+    {
+        int hole = slotOf(key);
+        if (hole < 0) {
+            return false;
+        }
+        const int mask = m_keys.size() - 1;
+        int slot = hole;
+        for (;;) {
+            slot = (slot + 1) & mask;
+            if (m_keys.at(slot).isNull()) {
+                break;
+            }
+            const int home = int(m_keys.at(slot).hash()) & mask;
+            // home 落在 (hole, slot] 之间（考虑回绕）的元素不能移动
+            if (((slot - home) & mask) < ((slot - hole) & mask)) {
+                continue;
+            }
+            m_keys[hole] = m_keys.at(slot);
+            m_values[hole] = std::move(m_values[slot]);
+            hole = slot;
+        }
+        m_keys[hole] = NoteId();
+        m_values[hole] = T();
+        --m_size;
+        return true;
+    }
+
+private:
+    int slotOf(const NoteId &key) const
+    {
+        if (m_keys.isEmpty() || key.isNull()) {
+            return -1;
+        }
+        const int mask = m_keys.size() - 1;
+        int slot = int(key.hash()) & mask;
+        while (!m_keys.at(slot).isNull()) {
+            if (m_keys.at(slot) == key) {
+                return slot;
+            }
+            slot = (slot + 1) & mask;
+        }
+        return -1;
+    }
+
+    void rehash(int capacity)
+    {
+        QVector<NoteId> keys(capacity);
+        QVector<T> values(capacity);
+        std::swap(keys, m_keys);
+        std::swap(values, m_values);
+        m_size = 0;
+        for (int i = 0; i < keys.size(); ++i) {
+            if (!keys.at(i).isNull()) {
+                insert(keys.at(i), values.at(i));
+            }
+        }
+    }
+
+    QVector<NoteId> m_keys;
+    QVector<T> m_values;
+    int m_size = 0;
+};
+
+#endif // NOTEID_H
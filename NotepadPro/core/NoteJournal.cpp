@@ -0,0 +1,330 @@
+/**
+ * @file NoteJournal.cpp
+ * @brief 笔记写前日志实现
+ *
+ * 知识点：
+ * - QJsonDocument::Compact 紧凑格式，一条记录占一行
+ * - QTimer 单次定时器实现批量刷盘
+ * - fsync/_commit 保证数据真正写入磁盘
+ * - 回放时跳过崩溃导致的半行记录，追加前先补齐换行
+ */
+
+#include "NoteJournal.h"
+
+#include <QJsonDocument>
+#include <QFileInfo>
+#include <QDir>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+// 缓冲超过该大小时立即刷盘，否则等待定时器
+const int kFlushThresholdBytes = 64 * 1024;
+// 批量刷盘间隔（毫秒）
+const int kFlushIntervalMs = 1000;
+
+/**
+ * @brief 文件末尾不是换行时补一个换行
+ * @param path 日志路径
+ * @return 文件不存在、已以换行结尾或补写成功返回 true
+ *
+ * 崩溃可能留下只写了一半的最后一行；之后追加的记录必须从新的一行开始，
+ * 否则会与半行连在一起，回放时一起被丢弃
+ */
+bool terminateLastLine(const QString &path)
+{
+    QFile file(path);
+    if (!file.exists() || file.size() == 0) return true;
+    if (!file.open(QIODevice::ReadWrite) || !file.seek(file.size() - 1)) return false;
+
+    char last = 0;
+    if (!file.getChar(&last)) return false;
+    return last == '\n' || file.write("\n", 1) == 1;
+}
+}
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+NoteJournal::NoteJournal(QObject *parent)
+    : QObject(parent)
+{
+    m_flushTimer = new QTimer(this);
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(kFlushIntervalMs);
+    connect(m_flushTimer, &QTimer::timeout, this, &NoteJournal::flush);
+}
+
+/**
+ * @brief 析构函数
+ *
+ * 关闭前把尚未落盘的记录写出
+ */
+NoteJournal::~NoteJournal()
+{
+    close();
+}
+
+/**
+ * @brief 打开（或创建）日志文件
+ * @param path 活动日志路径
+ * @return 打开成功返回 true
+ */
+bool NoteJournal::open(const QString &path)
+{
+    close();
+    m_file.setFileName(path);
+    return terminateLastLine(path) && m_file.open(QIODevice::WriteOnly | QIODevice::Append);
+}
+
+/**
+ * @brief 刷盘并关闭日志
+ */
+void NoteJournal::close()
+{
+    if (m_file.isOpen()) {
+        flush();
+        m_file.close();
+    }
+    m_flushTimer->stop();
+}
+
+bool NoteJournal::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+QString NoteJournal::path() const
+{
+    return m_file.fileName();
+}
+
+/**
+ * @brief 获取封存日志路径
+ * @return 封存日志路径（活动日志路径 + ".sealed"）
+ */
+QString NoteJournal::sealedPath() const
+{
+    return sealedPathFor(m_file.fileName());
+}
+
+// ========== 追加记录 ==========
+
+void NoteJournal::appendNote(const QJsonObject &note)
+{
+    QJsonObject record;
+    record["op"] = "note";
+    record["data"] = note;
+    append(record);
+}
+
+void NoteJournal::appendNoteRemoval(const QString &id)
+{
+    QJsonObject record;
+    record["op"] = "noteRemoved";
+    record["id"] = id;
+    append(record);
+}
+
+void NoteJournal::appendCategory(const QJsonObject &category)
+{
+    QJsonObject record;
+    record["op"] = "category";
+    record["data"] = category;
+    append(record);
+}
+
+void NoteJournal::appendCategoryRemoval(const QString &id)
+{
+    QJsonObject record;
+    record["op"] = "categoryRemoved";
+    record["id"] = id;
+    append(record);
+}
+
+/**
+ * @brief 追加一条记录到内存缓冲
+ * @param record 记录对象
+ *
+ * 缓冲较大时立即刷盘，否则启动定时器，把一段时间内的记录合并为一次 fsync
+ */
+void NoteJournal::append(const QJsonObject &record)
+{
+    if (!m_file.isOpen()) return;
+
+    m_pending += QJsonDocument(record).toJson(QJsonDocument::Compact);
+    m_pending += '\n';
+
+    if (m_pending.size() >= kFlushThresholdBytes) {
+        flush();
+    } else if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+/**
+ * @brief 把缓冲写入文件并同步到磁盘
+ * @return 写入成功返回 true
+ */
+bool NoteJournal::flush()
+{
+    m_flushTimer->stop();
+    if (!m_file.isOpen()) return false;
+    if (m_pending.isEmpty()) return true;
+
+    if (m_file.write(m_pending) != m_pending.size() || !m_file.flush()) {
+        return false;
+    }
+    m_pending.clear();
+
+#ifdef Q_OS_WIN
+    return _commit(m_file.handle()) == 0;
+#else
+    return ::fsync(m_file.handle()) == 0;
+#endif
+}
+
+/**
+ * @brief 获取日志大小（含未刷盘部分）
+ * @return 字节数
+ */
+qint64 NoteJournal::size() const
+{
+    return m_file.size() + m_pending.size();
+}
+
+/**
+ * @brief 封存当前日志，开始新的活动日志
+ * @return 封存成功返回 true
+ *
+ * 封存后的日志由快照合并接管：新快照写入成功后调用 discardSealed() 删除。
+ * 如果上一次合并失败留下了封存文件，则把当前日志追加到它后面，保证不丢记录；
+ * 封存文件可能以崩溃留下的半行结尾，追加前先补齐换行。
+ */
+bool NoteJournal::seal()
+{
+    if (!m_file.isOpen() || !flush()) return false;
+
+    const QString activePath = m_file.fileName();
+    const QString sealed = sealedPath();
+    m_file.close();
+
+    bool ok = true;
+    if (QFile::exists(sealed)) {
+        QFile active(activePath);
+        QFile target(sealed);
+        ok = terminateLastLine(sealed) &&
+             active.open(QIODevice::ReadOnly) &&
+             target.open(QIODevice::WriteOnly | QIODevice::Append) &&
+             target.write(active.readAll()) >= 0;
+        active.close();
+        target.close();
+        if (ok) {
+            QFile::remove(activePath);
+        }
+    } else {
+        ok = QFile::rename(activePath, sealed);
+    }
+
+    m_file.setFileName(activePath);
+    return m_file.open(QIODevice::WriteOnly | QIODevice::Append) && ok;
+}
+
+/**
+ * @brief 删除封存日志（快照已包含其中全部记录）
+ */
+void NoteJournal::discardSealed()
+{
+    QFile::remove(sealedPath());
+}
+
+/**
+ * @brief 清空全部日志（完整快照已包含其中所有记录）
+ */
+void NoteJournal::reset()
+{
+    m_flushTimer->stop();
+    m_pending.clear();
+    discardSealed();
+    if (m_file.isOpen()) {
+        m_file.resize(0);
+    }
+}
+
+/**
+ * @brief 回放日志文件
+ * @param path 日志路径
+ * @param apply 每条记录的处理函数
+ * @return 文件不存在或读取完成返回 true，无法打开返回 false
+ *
+ * 知识点：
+ * - QIODevice::readLine() 逐行读取
+ * - 崩溃时最后一行可能只写了一半；之后追加的记录从新的一行开始（见 terminateLastLine()），
+ *   因此解析失败的行只跳过，继续回放后面的记录
+ */
+bool NoteJournal::replay(const QString &path,
+                         const std::function<void(const QJsonObject &record)> &apply)
+{
+    QFile file(path);
+    if (!file.exists()) return true;
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty()) continue;
+
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(line, &error);
+        if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+            continue;
+        }
+        apply(doc.object());
+    }
+    return true;
+}
+
+/**
+ * @brief 根据数据文件路径推导日志路径
+ * @param dataFilePath 数据文件路径，如 notepad_data.json
+ * @return 日志路径，如 notepad_data.journal
+ */
+QString NoteJournal::journalPathFor(const QString &dataFilePath)
+{
+    QFileInfo info(dataFilePath);
+    return info.dir().filePath(info.completeBaseName() + ".journal");
+}
+
+/**
+ * @brief 根据活动日志路径推导封存日志路径
+ * @param journalPath 活动日志路径
+ * @return 封存日志路径
+ */
+QString NoteJournal::sealedPathFor(const QString &journalPath)
+{
+    return journalPath + ".sealed";
+}
+
+/**
+ * @brief 检查磁盘上是否存在日志（活动或封存）
+ * @param journalPath 活动日志路径
+ * @return 存在任意日志文件返回 true
+ */
+bool NoteJournal::hasFiles(const QString &journalPath)
+{
+    return QFile::exists(journalPath) || QFile::exists(sealedPathFor(journalPath));
+}
+
+/**
+ * @brief 删除日志文件（整文件快照已包含全部数据时使用）
+ * @param journalPath 活动日志路径
+ */
+void NoteJournal::removeFiles(const QString &journalPath)
+{
+    QFile::remove(journalPath);
+    QFile::remove(sealedPathFor(journalPath));
+}
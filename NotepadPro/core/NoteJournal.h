@@ -0,0 +1,75 @@
+/**
+ * @file NoteJournal.h
+ * @brief 笔记写前日志（追加式增量存储）
+ *
+ * 知识点：
+ * - QFile::Append 追加写入
+ * - 批量刷盘（fsync）降低磁盘同步次数
+ * - JSON Lines：每行一条紧凑 JSON 记录
+ * - 日志封存 + 快照合并（compaction）
+ */
+
+#ifndef NOTEJOURNAL_H
+#define NOTEJOURNAL_H
+
+#include <QObject>
+#include <QFile>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QTimer>
+
+#include <functional>
+
+/**
+ * @class NoteJournal
+ * @brief 追加式写前日志
+ *
+ * 每次笔记/分类变化只追加一条紧凑记录，而不是重写整个数据文件。
+ * 记录先缓存在内存中，按批次写入并 fsync；快照合并前先“封存”当前日志，
+ * 封存文件在新快照落盘后删除，加载时按 快照 -> 封存日志 -> 活动日志 的顺序回放。
+ */
+class NoteJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit NoteJournal(QObject *parent = nullptr);
+    ~NoteJournal() override;
+
+    // 打开/关闭
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const;
+    QString path() const;
+    QString sealedPath() const;
+
+    // 追加记录
+    void appendNote(const QJsonObject &note);
+    void appendNoteRemoval(const QString &id);
+    void appendCategory(const QJsonObject &category);
+    void appendCategoryRemoval(const QString &id);
+
+    // 刷盘与合并
+    bool flush();
+    qint64 size() const;
+    bool seal();
+    void discardSealed();
+    void reset();
+
+    // 回放与路径
+    static bool replay(const QString &path,
+                       const std::function<void(const QJsonObject &record)> &apply);
+    static QString journalPathFor(const QString &dataFilePath);
+    static QString sealedPathFor(const QString &journalPath);
+    static bool hasFiles(const QString &journalPath);
+    static void removeFiles(const QString &journalPath);
+
+private:
+    void append(const QJsonObject &record);
+
+    QFile m_file;
+    QByteArray m_pending;
+    QTimer *m_flushTimer;
+};
+
+#endif // NOTEJOURNAL_H
@@ -9,16 +9,222 @@
  * - QFile 文件读写操作
  * - QStandardPaths 获取标准路径
  * - 信号槽机制实现数据变化通知
+ * - 写前日志 + 后台快照合并
+ * - AsyncSaver 在工作线程序列化和写盘，GUI 线程只收集记录
+ * - QSet 记录逐条脏标记，增量写入只涉及变化的笔记/分类
+ * - 存储后端（SQLite）逐条写入并提供索引查询
+ * - 倒排索引全文搜索，随笔记修改增量更新
+ * - 笔记按列存储，修改统一经过 touchNote() 发出带字段掩码的 notesModified()
  */
 
 #include "NoteManager.h"
+#include "Note.h"
+#include "NoteJournal.h"
+#include "BinarySnapshot.h"
+#include "NoteDirectory.h"
+#include "SqliteNoteStorage.h"
 
 #include <QFile>
-#include <QJsonDocument>
 #include <QJsonObject>
-#include <QJsonArray>
 #include <QStandardPaths>
 #include <QDir>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+// 日志超过该大小时在后台合并为新快照
+const qint64 kCompactionThreshold = 4 * 1024 * 1024;
+// 后台预取最多占用正文缓存容量的比例（分母）
+const int kPrefetchCacheShare = 2;
+// 搜索排序：刚修改的笔记最多加成 50%，每 30 天减半；置顶笔记得分加倍
+const double kRecencyBoost = 0.5;
+const double kRecencyHalfLifeDays = 30.0;
+const double kPinnedBoost = 2.0;
+// 全文索引文件的扩展名，与数据文件同名放在同一目录
+const char kSearchIndexSuffix[] = ".searchindex";
+
+/**
+ * @brief 原子地写入 JSON 文件
+ * @param path 目标路径
+ * @param notes 笔记记录
+ * @param categories 分类记录
+ * @param progress 进度回调（可选）
+ * @return 写入成功返回 true
+ *
+ * 知识点：
+ * - 逐条流式写出，不在内存中构造整个 QJsonDocument
+ * - QSaveFile 先写临时文件，commit() 时再替换目标文件，中途失败不会损坏旧数据
+ * - 不访问任何 QObject，可以在工作线程中调用
+ */
+bool writeJsonFile(const QString &path, const QList<NoteRecord> &notes,
+                   const QList<CategoryRecord> &categories,
+                   const JsonStream::ProgressCallback &progress = JsonStream::ProgressCallback())
+{
+    return JsonStream::write(path, notes, categories, progress) == JsonStream::Ok;
+}
+
+/**
+ * @brief 流式读取 JSON 数据文件
+ * @param path 文件路径
+ * @param notes 输出笔记记录
+ * @param categories 输出分类记录
+ * @param progress 进度回调（可选）
+ * @return 读取成功返回 true
+ */
+bool readJsonFile(const QString &path, QList<NoteRecord> *notes,
+                  QList<CategoryRecord> *categories,
+                  const JsonStream::ProgressCallback &progress = JsonStream::ProgressCallback())
+{
+    auto onNote = [notes](const NoteRecord &note) { notes->append(note); };
+    auto onCategory = [categories](const CategoryRecord &cat) { categories->append(cat); };
+    return JsonStream::read(path, onNote, onCategory, progress) == JsonStream::Ok;
+}
+
+/**
+ * @brief 读取数据文件，自动识别 JSON、二进制快照、数据目录或 SQLite 数据库
+ * @param lazyContent 为 true 时二进制快照/数据目录只读取元数据，正文按需加载
+ */
+bool readDataFile(const QString &path, QList<NoteRecord> *notes,
+                  QList<CategoryRecord> *categories, bool lazyContent)
+{
+    if (SqliteNoteStorage::isSqliteFile(path)) {
+        SqliteNoteStorage storage;
+        return storage.open(path) && storage.load(notes, categories);
+    }
+    if (NoteDirectory::isNoteDirectory(path)) {
+        QSharedPointer<NoteDirectory> directory = QSharedPointer<NoteDirectory>::create(path);
+        return directory->load(notes, categories, lazyContent);
+    }
+    if (!BinarySnapshot::isSnapshotFile(path)) {
+        return readJsonFile(path, notes, categories);
+    }
+
+    QSharedPointer<BinarySnapshot> snapshot = QSharedPointer<BinarySnapshot>::create();
+    if (!snapshot->open(path)) {
+        return false;
+    }
+    notes->reserve(snapshot->noteCount());
+    for (int i = 0; i < snapshot->noteCount(); ++i) {
+        notes->append(snapshot->note(i, !lazyContent));
+    }
+    categories->reserve(snapshot->categoryCount());
+    for (int i = 0; i < snapshot->categoryCount(); ++i) {
+        categories->append(snapshot->category(i));
+    }
+    return true;
+}
+
+/**
+ * @brief 按指定格式写入数据文件
+ * @param compress 二进制快照是否分块压缩正文（其他格式忽略）
+ */
+bool writeDataFile(const QString &path, NoteManager::StorageFormat format,
+                   const QList<NoteRecord> &notes, const QList<CategoryRecord> &categories,
+                   bool compress = false)
+{
+    if (format == NoteManager::BinaryFormat) {
+        return BinarySnapshot::write(path, notes, categories, compress);
+    }
+    if (format == NoteManager::DirectoryFormat) {
+        return NoteDirectory::write(path, notes, categories);
+    }
+    if (format == NoteManager::SqliteFormat) {
+        SqliteNoteStorage storage;
+        return storage.open(path) && storage.saveAll(notes, categories);
+    }
+    return writeJsonFile(path, notes, categories);
+}
+
+/**
+ * @brief 根据路径推断文件格式
+ *
+ * .npdb 为二进制快照；.db 为 SQLite 数据库；
+ * 已存在的目录或没有扩展名的路径为数据目录；其余为 JSON
+ */
+NoteManager::StorageFormat formatForPath(const QString &path)
+{
+    const QFileInfo info(path);
+    if (info.suffix().compare("npdb", Qt::CaseInsensitive) == 0) {
+        return NoteManager::BinaryFormat;
+    }
+    if (info.suffix().compare("db", Qt::CaseInsensitive) == 0) {
+        return NoteManager::SqliteFormat;
+    }
+    if (info.isDir() || info.suffix().isEmpty()) {
+        return NoteManager::DirectoryFormat;
+    }
+    return NoteManager::JsonFormat;
+}
+
+/**
+ * @brief 笔记元数据在全文索引中的指纹
+ * @param record 笔记记录
+ * @return 64 位散列
+ *
+ * 标题、分类、置顶、修改时间（秒）和正文长度按 FNV-1a 散列，都不需要读取正文；
+ * 同一秒内修改、长度又没有变化的正文由 searchContentHash() 发现
+ */
+quint64 searchFingerprint(const NoteRecord &record)
+{
+    quint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](quint64 value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (value >> (i * 8)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+    for (const QChar ch : record.title) {
+        mix(ch.unicode());
+    }
+    for (const QChar ch : record.categoryId) {
+        mix(ch.unicode());
+    }
+    mix(record.isPinned ? 1 : 0);
+    mix(quint64(record.updatedAt.toSecsSinceEpoch()));
+    mix(quint64(record.contentSize()));
+    return hash;
+}
+
+/**
+ * @brief 正文在全文索引中的散列
+ * @param content 笔记正文
+ * @return qHashBits() 散列全部 UTF-16 数据
+ */
+quint64 searchContentHash(const QString &content)
+{
+    return quint64(qHashBits(content.constData(), size_t(content.size()) * sizeof(QChar)));
+}
+
+/**
+ * @brief 笔记在全文索引中参与过滤的属性
+ */
+SearchIndex::Metadata searchMetadata(const NoteRecord &record)
+{
+    SearchIndex::Metadata metadata;
+    metadata.categoryId = record.categoryId;
+    metadata.pinned = record.isPinned;
+    metadata.updatedAt = record.updatedAt;
+    return metadata;
+}
+
+/**
+ * @brief 读取一条笔记的正文（后台预取，在工作线程中调用）
+ */
+QPair<QString, QString> prefetchContent(const NoteRecord &record)
+{
+    return qMakePair(record.id, record.loadContent());
+}
+}
 
 // 静态成员初始化 - 单例模式的实例指针
 NoteManager* NoteManager::s_instance = nullptr;
@@ -50,8 +256,45 @@ NoteManager* NoteManager::instance()
 NoteManager::NoteManager(QObject *parent)
     : QObject(parent)
     , m_isDirty(false)
+    , m_isLoaded(false)
+    , m_storageFormat(JsonFormat)
+    , m_lazyContent(false)
+    , m_compressSnapshots(false)
+    , m_storage(nullptr)
+    , m_journal(new NoteJournal(this))
+    , m_journalEnabled(false)
+    , m_recordWriteTimer(new QTimer(this))
+    , m_saver(new AsyncSaver([this]() { return createSaveJob(); }, this))
+    , m_saveIsCompaction(false)
+    , m_changeSerial(0)
+    , m_savingSerial(0)
+    , m_searchIndex(new SearchIndex)
+    , m_searchIndexBuilt(false)
+    , m_searchBuildWatcher(new QFutureWatcher<PreparedSearchIndex>(this))
+    , m_searchBuildPending(false)
+    , m_adoptedSearchResults(0)
+    , m_savedSearchGeneration(std::numeric_limits<quint64>::max())
+    , m_searchWatcher(new QFutureWatcher<QVector<SearchIndex::Hit>>(this))
+    , m_searchLimit(DefaultSearchLimit)
+    , m_streamedHitCount(0)
+    , m_searchMode(KeywordSearch)
+    , m_prefetchWatcher(new QFutureWatcher<QPair<QString, QString>>(this))
 {
     m_dataFilePath = defaultDataPath();
+    connect(m_saver, &AsyncSaver::saveFinished, this, &NoteManager::onSaveFinished);
+    connect(m_prefetchWatcher, &QFutureWatcher<QPair<QString, QString>>::finished,
+            this, &NoteManager::onPrefetchFinished);
+    connect(m_searchWatcher, &QFutureWatcher<QVector<SearchIndex::Hit>>::resultsReadyAt,
+            this, &NoteManager::onSearchResultsReady);
+    connect(m_searchWatcher, &QFutureWatcher<QVector<SearchIndex::Hit>>::finished,
+            this, &NoteManager::onSearchFinished);
+    connect(m_searchBuildWatcher, &QFutureWatcher<PreparedSearchIndex>::resultReadyAt,
+            this, &NoteManager::onSearchIndexPrepared);
+
+    // 同一轮事件循环内的多次修改合并为一条日志记录
+    m_recordWriteTimer->setSingleShot(true);
+    m_recordWriteTimer->setInterval(0);
+    connect(m_recordWriteTimer, &QTimer::timeout, this, &NoteManager::writeDirtyRecords);
 }
 
 /**
@@ -59,67 +302,151 @@ NoteManager::NoteManager(QObject *parent)
  *
  * 知识点：
  * - qDeleteAll() 批量删除容器中的指针对象
- * - 防止内存泄漏
+ * - 防止内存泄漏（笔记句柄以管理器为父对象，随之自动删除）
  */
 NoteManager::~NoteManager()
 {
-    qDeleteAll(m_notes);
     qDeleteAll(m_categories);
+    delete m_storage;
+    delete m_searchIndex;
 }
 
 /**
  * @brief 创建新笔记
  * @param title 笔记标题（可选）
- * @return 新创建的笔记指针
+ * @param categoryId 所属分类ID（可选）
+ * @return 新笔记的ID
  *
  * 知识点：
- * - QHash::insert() 插入键值对
+ * - NoteId::generate() 生成随机 UUID，首 8 字节保证非 0，表中按 16 字节保存
  * - emit 发出信号通知观察者
  */
-Note* NoteManager::createNote(const QString &title)
+QString NoteManager::createNote(const QString &title, const QString &categoryId)
 {
-    Note *note = new Note(title.isEmpty() ? tr("新建笔记") : title, QString(), this);
-    connectNoteSignals(note);
-    m_notes.insert(note->id(), note);
-    setDirty(true);
-    emit noteCreated(note);
+    NoteRecord record;
+    record.id = NoteId::generate().toString();
+    record.title = title.isEmpty() ? tr("新建笔记") : title;
+    record.categoryId = categoryId;
+    record.createdAt = QDateTime::currentDateTime();
+    record.updatedAt = record.createdAt;
+    m_notes.insert(record);
+    markNoteDirty(record.id);
+    emit noteCreated(record.id);
     emit notesChanged();
-    return note;
+    return record.id;
 }
 
 /**
- * @brief 根据ID获取笔记
+ * @brief 笔记是否存在
  * @param id 笔记ID
- * @return 笔记指针，未找到返回 nullptr
+ * @return 存在返回 true
  */
-Note* NoteManager::getNote(const QString &id) const
+bool NoteManager::hasNote(const QString &id) const
 {
-    return m_notes.value(id, nullptr);
+    return m_notes.contains(id);
 }
 
 /**
  * @brief 获取所有笔记
- * @return 笔记列表
+ * @return 笔记ID列表
  */
-QList<Note*> NoteManager::getAllNotes() const
+QStringList NoteManager::getAllNoteIds() const
 {
-    return m_notes.values();
+    return m_notes.ids();
 }
 
 /**
  * @brief 根据分类ID获取笔记
  * @param categoryId 分类ID
- * @return 属于该分类的笔记列表
+ * @return 属于该分类的笔记ID列表
+ *
+ * 这是分类-笔记关联的核心方法。
+ * 使用存储后端且没有未写入的修改时走数据库索引，否则查笔记表的分类索引，
+ * 代价只与该分类的笔记数有关
+ */
+QStringList NoteManager::getNoteIdsByCategory(const QString &categoryId) const
+{
+    if (isStorageInSync()) {
+        return existingNoteIds(m_storage->noteIdsByCategory(categoryId));
+    }
+
+    // 索引中的行号无序，排序后与笔记表的顺序一致
+    QVector<int> rows = m_notes.rowsInCategory(m_notes.findCategoryHandle(categoryId));
+    std::sort(rows.begin(), rows.end());
+
+    QStringList result;
+    result.reserve(rows.size());
+    for (int row : std::as_const(rows)) {
+        result.append(m_notes.id(row));
+    }
+    return result;
+}
+
+/**
+ * @brief 获取按“置顶优先、最近修改优先”排序的笔记
+ * @param categoryId 分类ID（为空表示全部笔记）
+ * @return 排好序的笔记ID列表
  *
- * 这是分类-笔记关联的核心方法
+ * 对行号排序，比较时直接读置顶列和修改时间列（整数），最后才取出ID；
+ * 指定分类时只对分类索引中的行排序
  */
-QList<Note*> NoteManager::getNotesByCategory(const QString &categoryId) const
+QStringList NoteManager::getNoteIdsPinnedFirst(const QString &categoryId) const
 {
-    QList<Note*> result;
-    for (Note *note : m_notes) {
-        if (note->categoryId() == categoryId) {
-            result.append(note);
+    if (isStorageInSync()) {
+        return existingNoteIds(m_storage->noteIdsPinnedFirst(categoryId));
+    }
+
+    QVector<int> rows;
+    if (categoryId.isEmpty()) {
+        rows.resize(m_notes.size());
+        std::iota(rows.begin(), rows.end(), 0);
+    } else {
+        rows = m_notes.rowsInCategory(m_notes.findCategoryHandle(categoryId));
+        std::sort(rows.begin(), rows.end());
+    }
+    std::stable_sort(rows.begin(), rows.end(), [this](int a, int b) {
+        if (m_notes.isPinned(a) != m_notes.isPinned(b)) {
+            return m_notes.isPinned(a);
         }
+        return m_notes.updatedMSecs(a) > m_notes.updatedMSecs(b);
+    });
+
+    QStringList result;
+    result.reserve(rows.size());
+    for (int row : std::as_const(rows)) {
+        result.append(m_notes.id(row));
+    }
+    return result;
+}
+
+/**
+ * @brief 获取最近修改的笔记
+ * @param limit 最多返回的数量
+ * @return 按修改时间从新到旧排序的笔记ID列表
+ */
+QStringList NoteManager::getRecentNoteIds(int limit) const
+{
+    if (isStorageInSync()) {
+        return existingNoteIds(m_storage->recentNoteIds(limit));
+    }
+
+    QVector<int> rows(m_notes.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    auto byUpdated = [this](int a, int b) {
+        return m_notes.updatedMSecs(a) > m_notes.updatedMSecs(b);
+    };
+    if (limit < rows.size()) {
+        const int count = qMax(0, limit);
+        std::partial_sort(rows.begin(), rows.begin() + count, rows.end(), byUpdated);
+        rows.resize(count);
+    } else {
+        std::sort(rows.begin(), rows.end(), byUpdated);
+    }
+
+    QStringList result;
+    result.reserve(rows.size());
+    for (int row : std::as_const(rows)) {
+        result.append(m_notes.id(row));
     }
     return result;
 }
@@ -127,17 +454,123 @@ QList<Note*> NoteManager::getNotesByCategory(const QString &categoryId) const
 /**
  * @brief 搜索笔记
  * @param keyword 搜索关键词
- * @return 匹配的笔记列表
+ * @param limit 最多返回的数量
+ * @return 按相关度从高到低排序的笔记ID列表
+ *
+ * 在全文索引中查找：关键词的每个词都出现（按词匹配），
+ * 或关键词整体作为子串出现（按 trigram 缩小范围后验证）的笔记都会命中。
+ * 关键词中含有字段过滤、短语或排除语法时按结构化查询处理（见 SearchQuery）
+ */
+QStringList NoteManager::searchNotes(const QString &keyword, int limit) const
+{
+    updateSearchIndex();
+    m_searchIndex->setBodyReadLimit(limit);
+    const SearchQuery query = parseSearchQuery(keyword);
+    return rankSearchHits(query.hasFilters() ? m_searchIndex->searchQuery(query)
+                                             : m_searchIndex->search(keyword), limit);
+}
+
+/**
+ * @brief 用正则表达式搜索笔记（不区分大小写）
+ * @param pattern 正则表达式
+ * @param limit 最多返回的数量
+ * @return 标题或正文纯文本能匹配的笔记，按相关度排序；表达式无效时返回空列表
+ */
+QStringList NoteManager::searchNotesByRegex(const QString &pattern, int limit) const
+{
+    updateSearchIndex();
+    m_searchIndex->setBodyReadLimit(limit);
+    const QRegularExpression regex(pattern, QRegularExpression::CaseInsensitiveOption);
+    return rankSearchHits(m_searchIndex->searchRegex(regex), limit);
+}
+
+/**
+ * @brief 按标题模糊搜索笔记
+ * @param title 标题中的词（顺序不限，允许少量拼写错误）
+ * @param limit 最多返回的数量
+ * @return 按匹配质量从高到低排序的笔记
+ *
+ * 只看匹配质量，不加新近度和置顶加成：打错字的旧笔记不应排在完全匹配的笔记前面
  */
-QList<Note*> NoteManager::searchNotes(const QString &keyword) const
+QStringList NoteManager::searchNotesFuzzy(const QString &title, int limit) const
 {
-    QList<Note*> result;
-    for (Note *note : m_notes) {
-        if (note->containsText(keyword)) {
-            result.append(note);
+    updateSearchIndex();
+    return rankSearchHits(m_searchIndex->searchFuzzyTitle(title), limit, false);
+}
+
+/**
+ * @brief 在后台线程中搜索笔记，边查边送回结果
+ * @param keyword 搜索关键词、正则表达式或标题中的词
+ * @param mode 搜索方式
+ * @param limit 最终结果最多保留的数量
+ *
+ * 知识点：
+ * - QFutureInterface 手动汇报结果，每批命中用 reportResult() 送出，
+ *   QFutureWatcher 在 GUI 线程中发出 resultsReadyAt()
+ * - 工作线程只读取索引的副本（隐式共享，复制时不拷贝数据），不接触笔记表
+ * - 新的搜索会取消上一次搜索，工作线程在下一批检查前发现后立即退出
+ *
+ * 查询过程中先发出 searchResultsAvailable()（未排序的部分结果，合计不超过 limit 条），
+ * 全部完成后发出 searchFinished()（按相关度排序、截取前 limit 条）
+ */
+void NoteManager::searchNotesAsync(const QString &keyword, SearchMode mode, int limit)
+{
+    cancelSearch();
+    updateSearchIndex();
+
+    m_searchSnapshot.reset(new SearchIndex(*m_searchIndex));
+    m_searchSnapshot->setBodyReadLimit(limit);
+    m_searchHits.clear();
+    m_streamedHitCount = 0;
+    m_searchLimit = limit;
+    m_searchMode = mode;
+
+    QFutureInterface<QVector<SearchIndex::Hit>> promise;
+    promise.reportStarted();
+    m_searchWatcher->setFuture(promise.future());
+
+    const QSharedPointer<SearchIndex> index = m_searchSnapshot;
+    const SearchQuery query = mode == KeywordSearch ? parseSearchQuery(keyword) : SearchQuery();
+    QtConcurrent::run([promise, index, keyword, query, mode]() mutable {
+        auto onBatch = [&promise](const QVector<SearchIndex::Hit> &batch) {
+            if (promise.isCanceled()) {
+                return false;
+            }
+            if (!batch.isEmpty()) {
+                promise.reportResult(batch);
+            }
+            return true;
+        };
+        switch (mode) {
+        case KeywordSearch:
+            if (query.hasFilters()) {
+                index->searchQuery(query, onBatch);
+            } else {
+                index->search(keyword, onBatch);
+            }
+            break;
+        case RegexSearch:
+            index->searchRegex(QRegularExpression(keyword, QRegularExpression::CaseInsensitiveOption),
+                               onBatch);
+            break;
+        case FuzzyTitleSearch:
+            index->searchFuzzyTitle(keyword, onBatch);
+            break;
         }
-    }
-    return result;
+        promise.reportFinished();
+    });
+}
+
+/**
+ * @brief 取消正在进行的后台搜索（没有时什么也不做）
+ *
+ * 取消后不会再发出 searchResultsAvailable() 和 searchFinished()
+ */
+void NoteManager::cancelSearch()
+{
+    m_searchWatcher->cancel();
+    m_searchSnapshot.clear();
+    m_searchHits.clear();
 }
 
 /**
@@ -145,19 +578,17 @@ QList<Note*> NoteManager::searchNotes(const QString &keyword) const
  * @param id 笔记ID
  * @return 删除成功返回 true
  *
- * 知识点：
- * - QHash::take() 移除并返回值
+ * 笔记的句柄（如有）同时失效
  */
 bool NoteManager::deleteNote(const QString &id)
 {
     if (!m_notes.contains(id)) {
         return false;
     }
-    Note *note = m_notes.take(id);
-    QString noteId = note->id();
-    delete note;
-    setDirty(true);
-    emit noteDeleted(noteId);
+    removeNoteRow(id);
+    NoteContentCache::instance()->remove(id);
+    markNoteRemoved(id);
+    emit noteDeleted(id);
     emit notesChanged();
     return true;
 }
@@ -168,7 +599,195 @@ bool NoteManager::deleteNote(const QString &id)
  */
 int NoteManager::noteCount() const
 {
-    return m_notes.count();
+    return m_notes.size();
+}
+
+/**
+ * @brief 获取笔记的纯数据记录
+ * @param id 笔记ID
+ * @return 笔记记录，不存在时返回空记录
+ */
+NoteRecord NoteManager::noteRecord(const QString &id) const
+{
+    const int row = m_notes.rowOf(id);
+    return row >= 0 ? m_notes.record(row) : NoteRecord();
+}
+
+/**
+ * @brief 获取笔记标题
+ */
+QString NoteManager::noteTitle(const QString &id) const
+{
+    const int row = m_notes.rowOf(id);
+    return row >= 0 ? m_notes.title(row) : QString();
+}
+
+/**
+ * @brief 获取笔记正文（按需加载时经 LRU 缓存从磁盘读取）
+ */
+QString NoteManager::noteContent(const QString &id) const
+{
+    const int row = m_notes.rowOf(id);
+    return row >= 0 ? m_notes.content(row) : QString();
+}
+
+/**
+ * @brief 获取笔记所属分类ID
+ */
+QString NoteManager::noteCategoryId(const QString &id) const
+{
+    const int row = m_notes.rowOf(id);
+    return row >= 0 ? m_notes.categoryId(row) : QString();
+}
+
+/**
+ * @brief 获取笔记创建时间
+ */
+QDateTime NoteManager::noteCreatedAt(const QString &id) const
+{
+    const int row = m_notes.rowOf(id);
+    return row >= 0 ? m_notes.createdAt(row) : QDateTime();
+}
+
+/**
+ * @brief 获取笔记修改时间
+ */
+QDateTime NoteManager::noteUpdatedAt(const QString &id) const
+{
+    const int row = m_notes.rowOf(id);
+    return row >= 0 ? m_notes.updatedAt(row) : QDateTime();
+}
+
+/**
+ * @brief 笔记是否置顶
+ */
+bool NoteManager::isNotePinned(const QString &id) const
+{
+    const int row = m_notes.rowOf(id);
+    return row >= 0 && m_notes.isPinned(row);
+}
+
+/**
+ * @brief 笔记正文是否已在内存中
+ */
+bool NoteManager::isNoteContentLoaded(const QString &id) const
+{
+    const int row = m_notes.rowOf(id);
+    return row < 0 || m_notes.isContentLoaded(row);
+}
+
+/**
+ * @brief 获取笔记正文的纯文本（缓存，正文修改时重新计算）
+ */
+QString NoteManager::notePlainText(const QString &id) const
+{
+    const int row = m_notes.rowOf(id);
+    return row >= 0 ? m_notes.plainText(row) : QString();
+}
+
+/**
+ * @brief 获取笔记正文预览
+ * @param id 笔记ID
+ * @param maxLength 最大长度
+ */
+QString NoteManager::notePreview(const QString &id, int maxLength) const
+{
+    const int row = m_notes.rowOf(id);
+    return row >= 0 ? m_notes.preview(row, maxLength) : QString();
+}
+
+/**
+ * @brief 设置笔记标题
+ * @param id 笔记ID
+ * @param title 新标题
+ *
+ * 知识点：
+ * - 属性变化检测：只有值真正改变时才更新和通知
+ */
+void NoteManager::setNoteTitle(const QString &id, const QString &title)
+{
+    const int row = m_notes.rowOf(id);
+    if (row >= 0 && m_notes.title(row) != title) {
+        m_notes.setTitle(row, title);
+        touchNote(row, TitleField);
+    }
+}
+
+/**
+ * @brief 设置笔记正文
+ * @param id 笔记ID
+ * @param content 新内容
+ */
+void NoteManager::setNoteContent(const QString &id, const QString &content)
+{
+    const int row = m_notes.rowOf(id);
+    if (row >= 0 && m_notes.content(row) != content) {
+        m_notes.setContent(row, content);
+        touchNote(row, ContentField);
+    }
+}
+
+/**
+ * @brief 设置笔记所属分类
+ * @param id 笔记ID
+ * @param categoryId 分类ID
+ *
+ * 这是笔记与分类关联的关键方法
+ */
+void NoteManager::setNoteCategoryId(const QString &id, const QString &categoryId)
+{
+    const int row = m_notes.rowOf(id);
+    if (row >= 0 && m_notes.categoryHandle(row) != m_notes.findCategoryHandle(categoryId)) {
+        m_notes.setCategoryId(row, categoryId);
+        touchNote(row, CategoryField);
+    }
+}
+
+/**
+ * @brief 设置笔记置顶状态
+ * @param id 笔记ID
+ * @param pinned 是否置顶
+ */
+void NoteManager::setNotePinned(const QString &id, bool pinned)
+{
+    const int row = m_notes.rowOf(id);
+    if (row >= 0 && m_notes.isPinned(row) != pinned) {
+        m_notes.setPinned(row, pinned);
+        touchNote(row, PinnedField);
+    }
+}
+
+/**
+ * @brief 打开笔记句柄（编辑器中的笔记使用）
+ * @param id 笔记ID
+ * @return 句柄，笔记不存在时返回 nullptr
+ *
+ * 同一条笔记只有一个句柄，由管理器持有；
+ * 笔记被删除、或调用方 closeNote() 后句柄被释放
+ */
+Note* NoteManager::openNote(const QString &id)
+{
+    if (!m_notes.contains(id)) {
+        return nullptr;
+    }
+    Note *&note = m_noteHandles[id];
+    if (!note) {
+        note = new Note(this, id);
+    }
+    return note;
+}
+
+/**
+ * @brief 释放笔记句柄（不再编辑该笔记时调用）
+ * @param id 笔记ID
+ *
+ * 句柄延迟删除，当前事件处理中仍然可以使用
+ */
+void NoteManager::closeNote(const QString &id)
+{
+    if (Note *note = m_noteHandles.take(id)) {
+        note->deleteLater();
+    }
 }
 
 /**
@@ -181,7 +800,7 @@ Category* NoteManager::createCategory(const QString &name)
     Category *category = new Category(name, this);
     connectCategorySignals(category);
     m_categories.insert(category->id(), category);
-    setDirty(true);
+    markCategoryDirty(category->id());
     emit categoryCreated(category);
     emit categoriesChanged();
     return category;
@@ -250,7 +869,7 @@ bool NoteManager::deleteCategory(const QString &id)
     Category *category = m_categories.take(id);
     QString catId = category->id();
     delete category;
-    setDirty(true);
+    markCategoryRemoved(catId);
     emit categoryDeleted(catId);
     emit categoriesChanged();
     return true;
@@ -265,46 +884,55 @@ int NoteManager::categoryCount() const
     return m_categories.count();
 }
 
+/**
+ * @brief 获取某个分类中的笔记数
+ * @param categoryId 分类ID（为空表示未分类的笔记）
+ * @return 笔记数，直接取分类索引中行号列表的长度
+ */
+int NoteManager::noteCountInCategory(const QString &categoryId) const
+{
+    return m_notes.countInCategory(m_notes.findCategoryHandle(categoryId));
+}
+
 /**
  * @brief 保存数据到文件
  * @param filePath 文件路径（可选，默认使用内部路径）
- * @return 保存成功返回 true
+ * @return 保存成功（或已提交后台保存）返回 true
  *
  * 知识点：
- * - QJsonDocument 创建 JSON 文档
- * - QJsonArray 存储数组数据
- * - QFile::open(QIODevice::WriteOnly) 写入模式
+ * - 日志模式下只需把增量记录刷盘，保存代价与修改量成正比
+ * - 日志过大时在后台把它合并为新的快照
+ * - 存储后端模式下在一个事务中写入变化的记录
+ * - 整文件模式下保存默认数据文件时交给 AsyncSaver 在后台写入，
+ *   写完后通过 dataSaved（或 saveFailed）信号通知
+ * - 保存到其他路径时同步写入
  */
 bool NoteManager::saveToFile(const QString &filePath)
 {
     QString path = filePath.isEmpty() ? m_dataFilePath : filePath;
 
-    QJsonObject root;
-
-    // 保存笔记
-    QJsonArray notesArray;
-    for (Note *note : m_notes) {
-        notesArray.append(note->toJson());
-    }
-    root["notes"] = notesArray;
-
-    // 保存分类
-    QJsonArray categoriesArray;
-    for (Category *cat : m_categories) {
-        categoriesArray.append(cat->toJson());
-    }
-    root["categories"] = categoriesArray;
-
-    QJsonDocument doc(root);
-
-    QFile file(path);
-    if (!file.open(QIODevice::WriteOnly)) {
+    if (path == m_dataFilePath && m_storage) {
+        if (!writeDirtyRecords()) {
+            emit saveFailed();
+            return false;
+        }
+    } else if (path == m_dataFilePath) {
+        if (!m_journalEnabled) {
+            m_saver->requestSave();
+            return true;
+        }
+        writeDirtyRecords();
+        if (!m_journal->flush()) {
+            emit saveFailed();
+            return false;
+        }
+        if (m_journal->size() >= kCompactionThreshold) {
+            m_saver->requestSave();
+        }
+    } else if (!writeSnapshot(path)) {
         return false;
     }
 
-    file.write(doc.toJson());
-    file.close();
-
     setDirty(false);
     emit dataSaved();
     return true;
@@ -316,57 +944,147 @@ bool NoteManager::saveToFile(const QString &filePath)
  * @return 加载成功返回 true
  *
  * 知识点：
- * - QJsonDocument::fromJson() 解析 JSON
- * - QFile::readAll() 读取全部内容
+ * - 按文件头识别 JSON 或二进制快照
+ * - 默认数据文件不存在时，从另一种格式的数据文件迁移
+ * - 在快照之上回放写前日志
  */
 bool NoteManager::loadFromFile(const QString &filePath)
 {
     QString path = filePath.isEmpty() ? m_dataFilePath : filePath;
+    const bool isDataFile = path == m_dataFilePath;
 
-    QFile file(path);
-    if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
-        return false;
+    bool migrated = false;
+    if (isDataFile && !QFile::exists(path)) {
+        for (StorageFormat format : {JsonFormat, BinaryFormat, DirectoryFormat, SqliteFormat}) {
+            const QString legacyPath = dataPathFor(format);
+            if (format != m_storageFormat && QFile::exists(legacyPath)) {
+                path = legacyPath;
+                migrated = true;
+                break;
+            }
+        }
     }
 
-    QByteArray data = file.readAll();
-    file.close();
+    // 只有默认数据文件带写前日志
+    const QString journalPath = NoteJournal::journalPathFor(m_dataFilePath);
+    const bool hasJournal = isDataFile && NoteJournal::hasFiles(journalPath);
 
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (doc.isNull()) {
+    waitForPendingSaves();
+    m_prefetchWatcher->cancel();
+    m_prefetchWatcher->waitForFinished();
+
+    QList<NoteRecord> notes;
+    QList<CategoryRecord> categories;
+    if (QFile::exists(path)) {
+        const bool ok = (m_storage && path == m_dataFilePath)
+                ? openStorage() && m_storage->load(&notes, &categories)
+                : readDataFile(path, &notes, &categories, m_lazyContent);
+        if (!ok) {
+            return false;
+        }
+    } else if (!hasJournal) {
         return false;
     }
 
-    QJsonObject root = doc.object();
-
     // 清空现有数据
-    qDeleteAll(m_notes);
     m_notes.clear();
     qDeleteAll(m_categories);
     m_categories.clear();
+    NoteContentCache::instance()->clear();
+    resetSearchIndex();
 
-    // 加载笔记
-    QJsonArray notesArray = root["notes"].toArray();
-    for (const QJsonValue &val : notesArray) {
-        Note *note = Note::fromJson(val.toObject(), this);
-        connectNoteSignals(note);
-        m_notes.insert(note->id(), note);
+    m_notes.reserve(notes.size());
+    for (const NoteRecord &record : notes) {
+        insertNote(record);
+    }
+    for (const CategoryRecord &record : categories) {
+        insertCategory(record);
     }
 
-    // 加载分类
-    QJsonArray categoriesArray = root["categories"].toArray();
-    for (const QJsonValue &val : categoriesArray) {
-        Category *cat = Category::fromJson(val.toObject(), this);
-        connectCategorySignals(cat);
-        m_categories.insert(cat->id(), cat);
+    // 在快照之上依次回放封存日志和活动日志
+    if (hasJournal) {
+        auto apply = [this](const QJsonObject &record) { applyJournalRecord(record); };
+        NoteJournal::replay(NoteJournal::sealedPathFor(journalPath), apply);
+        NoteJournal::replay(journalPath, apply);
     }
 
+    // 新数据中已不存在的笔记，句柄随之失效
+    for (auto it = m_noteHandles.begin(); it != m_noteHandles.end();) {
+        if (m_notes.contains(it.key())) {
+            ++it;
+        } else {
+            it.value()->deleteLater();
+            it = m_noteHandles.erase(it);
+        }
+    }
+
+    m_isLoaded = true;
+    clearDirtyRecords();
     setDirty(false);
+
+    // 迁移后立即以当前格式写出，旧文件保留作为备份
+    if (migrated) {
+        writeSnapshot(m_dataFilePath);
+    }
+    loadSearchIndex();
+    startPrefetch();
+
     emit dataLoaded();
     emit notesChanged();
     emit categoriesChanged();
     return true;
 }
 
+/**
+ * @brief 导出全部数据为 JSON 文件
+ * @param filePath 目标文件路径
+ * @param progress 进度回调（已写入记录数, 记录总数），返回 false 取消导出
+ * @return 导出成功返回 true；失败或取消时目标文件保持不变
+ */
+bool NoteManager::exportToJson(const QString &filePath,
+                               const JsonStream::ProgressCallback &progress) const
+{
+    QList<NoteRecord> notes;
+    QList<CategoryRecord> categories;
+    collectRecords(&notes, &categories);
+    return writeJsonFile(filePath, notes, categories, progress);
+}
+
+/**
+ * @brief 从 JSON 文件导入数据
+ * @param filePath 源文件路径
+ * @param progress 进度回调（已读取字节数, 文件大小），返回 false 取消导入
+ * @return 导入成功返回 true；失败或取消时不修改现有数据
+ *
+ * 导入是合并操作：ID 相同的笔记/分类被覆盖，其余保留
+ */
+bool NoteManager::importFromJson(const QString &filePath,
+                                 const JsonStream::ProgressCallback &progress)
+{
+    QList<NoteRecord> notes;
+    QList<CategoryRecord> categories;
+    if (!readJsonFile(filePath, &notes, &categories, progress)) {
+        return false;
+    }
+
+    for (NoteRecord record : notes) {
+        // 外部文件中缺少ID的笔记分配新ID，而不是丢弃
+        if (record.id.isEmpty()) {
+            record.id = NoteId::generate().toString();
+        }
+        insertNote(record);
+        markNoteDirty(record.id);
+    }
+    for (const CategoryRecord &record : categories) {
+        insertCategory(record);
+        markCategoryDirty(record.id);
+    }
+
+    emit notesChanged();
+    emit categoriesChanged();
+    return true;
+}
+
 /**
  * @brief 获取默认数据文件路径
  * @return 数据文件完整路径
@@ -376,13 +1094,162 @@ bool NoteManager::loadFromFile(const QString &filePath)
  * - QDir::mkpath() 递归创建目录
  */
 QString NoteManager::defaultDataPath() const
+{
+    return dataPathFor(m_storageFormat);
+}
+
+/**
+ * @brief 获取指定格式的数据文件路径
+ * @param format 存储格式
+ * @return 数据文件完整路径（JSON 为 .json，二进制快照为 .npdb，SQLite 为 .db，数据目录无扩展名）
+ */
+QString NoteManager::dataPathFor(StorageFormat format) const
 {
     QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     QDir dir(dataDir);
     if (!dir.exists()) {
         dir.mkpath(".");
     }
-    return dataDir + "/notepad_data.json";
+    switch (format) {
+    case BinaryFormat:
+        return dataDir + "/notepad_data.npdb";
+    case DirectoryFormat:
+        return dataDir + "/notepad_data";
+    case SqliteFormat:
+        return dataDir + "/notepad_data.db";
+    default:
+        return dataDir + "/notepad_data.json";
+    }
+}
+
+/**
+ * @brief 等待后台写入完成
+ *
+ * 退出程序、重新加载或同步写入前调用，保证后台保存的快照已经落盘
+ */
+void NoteManager::waitForPendingSaves()
+{
+    m_saver->waitForIdle();
+    m_searchIndexSave.waitForFinished();
+}
+
+/**
+ * @brief 是否启用写前日志模式
+ * @return 启用返回 true
+ */
+bool NoteManager::isJournalEnabled() const
+{
+    return m_journalEnabled;
+}
+
+/**
+ * @brief 启用/关闭写前日志模式
+ * @param enabled 是否启用
+ *
+ * 日志只记录切换之后的变化，因此：
+ * - 启用时如有未保存的修改，先写一次完整快照
+ * - 关闭时把日志内容合并进快照并删除日志
+ */
+void NoteManager::setJournalEnabled(bool enabled)
+{
+    if (m_journalEnabled == enabled) {
+        return;
+    }
+    waitForPendingSaves();
+
+    if (enabled) {
+        if (m_isDirty && !writeSnapshot(m_dataFilePath)) {
+            return;
+        }
+        if (!m_journal->open(NoteJournal::journalPathFor(m_dataFilePath))) {
+            return;
+        }
+        clearDirtyRecords();
+        m_journalEnabled = true;
+    } else {
+        m_journalEnabled = false;
+        m_journal->close();
+        if ((m_isLoaded || m_isDirty) && writeSnapshot(m_dataFilePath)) {
+            setDirty(false);
+        }
+    }
+}
+
+/**
+ * @brief 是否启用正文按需加载
+ * @return 启用返回 true
+ */
+bool NoteManager::isLazyContentEnabled() const
+{
+    return m_lazyContent;
+}
+
+/**
+ * @brief 启用/关闭正文按需加载
+ * @param enabled 是否启用
+ *
+ * 对二进制快照和数据目录生效，下次加载数据时起作用：
+ * 启动时只读取标题、分类、时间戳等元数据，正文在首次打开时（或由后台预取）读取
+ */
+void NoteManager::setLazyContentEnabled(bool enabled)
+{
+    m_lazyContent = enabled;
+}
+
+/**
+ * @brief 是否压缩二进制快照的正文
+ * @return 启用返回 true
+ */
+bool NoteManager::isCompressionEnabled() const
+{
+    return m_compressSnapshots;
+}
+
+/**
+ * @brief 启用/关闭二进制快照正文压缩
+ * @param enabled 是否启用
+ *
+ * 下次写入快照时生效。压缩以块为单位，按需加载时只解压正文所在的块；
+ * 读取时根据文件头判断是否压缩，两种快照都能直接打开
+ */
+void NoteManager::setCompressionEnabled(bool enabled)
+{
+    m_compressSnapshots = enabled;
+}
+
+/**
+ * @brief 获取存储格式
+ * @return 当前存储格式
+ */
+NoteManager::StorageFormat NoteManager::storageFormat() const
+{
+    return m_storageFormat;
+}
+
+/**
+ * @brief 设置存储格式
+ * @param format 新的存储格式
+ *
+ * 数据已加载时立即以新格式写出完整快照；
+ * 尚未加载时只切换路径，加载时会自动从旧格式迁移
+ */
+void NoteManager::setStorageFormat(StorageFormat format)
+{
+    if (m_storageFormat == format) {
+        return;
+    }
+    waitForPendingSaves();
+
+    const bool hasData = m_isLoaded || m_isDirty;
+    m_storageFormat = format;
+    m_dataFilePath = defaultDataPath();
+
+    delete m_storage;
+    m_storage = format == SqliteFormat ? new SqliteNoteStorage() : nullptr;
+
+    if (hasData && writeSnapshot(m_dataFilePath)) {
+        setDirty(false);
+    }
 }
 
 /**
@@ -400,6 +1267,9 @@ bool NoteManager::isDirty() const
  */
 void NoteManager::setDirty(bool dirty)
 {
+    if (dirty) {
+        ++m_changeSerial;
+    }
     if (m_isDirty != dirty) {
         m_isDirty = dirty;
         emit dirtyChanged(m_isDirty);
@@ -407,29 +1277,920 @@ void NoteManager::setDirty(bool dirty)
 }
 
 /**
- * @brief 连接笔记信号
- * @param note 笔记对象指针
+ * @brief 连接分类信号
+ * @param category 分类对象指针
+ */
+void NoteManager::connectCategorySignals(Category *category)
+{
+    connect(category, &Category::categoryModified, this, [this, category]() {
+        markCategoryDirty(category->id());
+        emit categoryModified(category);
+    });
+}
+
+/**
+ * @brief 笔记的某些字段已被修改：更新修改时间、标记脏记录并通知
+ * @param row 笔记所在的行
+ * @param fields 修改的字段
+ *
+ * 知识点：
+ * - 所有笔记共用一个 notesModified() 信号，不必为每条笔记建立连接；
+ *   只有打开了句柄的笔记才额外发出逐字段的属性信号
+ */
+void NoteManager::touchNote(int row, NoteFields fields)
+{
+    const QString id = m_notes.id(row);
+    m_notes.setUpdatedAt(row, QDateTime::currentDateTime());
+    fields |= UpdatedAtField;
+
+    markNoteDirty(id);
+    if (Note *note = m_noteHandles.value(id, nullptr)) {
+        note->notifyChanged(fields);
+    }
+    emit notesModified(QStringList{id}, fields);
+}
+
+/**
+ * @brief 标记笔记已修改（或新建）
+ * @param id 笔记ID
+ */
+void NoteManager::markNoteDirty(const QString &id)
+{
+    // 后台准备索引期间同样记下，换上准备好的索引后重新索引这些笔记
+    if (m_searchIndexBuilt || m_searchBuildPending) {
+        m_staleSearchIds.insert(id);
+    }
+    m_removedNoteIds.remove(id);
+    m_dirtyNoteIds.insert(id);
+    scheduleRecordWrite();
+    setDirty(true);
+}
+
+/**
+ * @brief 标记笔记已删除
+ * @param id 笔记ID
+ */
+void NoteManager::markNoteRemoved(const QString &id)
+{
+    m_searchIndex->removeNote(id);
+    if (m_searchBuildPending) {
+        m_staleSearchIds.insert(id);    // 后台准备的索引中还有这条笔记
+    } else {
+        m_staleSearchIds.remove(id);
+    }
+    m_dirtyNoteIds.remove(id);
+    m_removedNoteIds.insert(id);
+    scheduleRecordWrite();
+    setDirty(true);
+}
+
+/**
+ * @brief 标记分类已修改（或新建）
+ * @param id 分类ID
+ */
+void NoteManager::markCategoryDirty(const QString &id)
+{
+    m_removedCategoryIds.remove(id);
+    m_dirtyCategoryIds.insert(id);
+    scheduleRecordWrite();
+    setDirty(true);
+}
+
+/**
+ * @brief 标记分类已删除
+ * @param id 分类ID
+ */
+void NoteManager::markCategoryRemoved(const QString &id)
+{
+    m_dirtyCategoryIds.remove(id);
+    m_removedCategoryIds.insert(id);
+    scheduleRecordWrite();
+    setDirty(true);
+}
+
+/**
+ * @brief 安排把变化的记录写入存储后端或写前日志
+ *
+ * 同一轮事件循环内的多次修改只写一次
+ */
+void NoteManager::scheduleRecordWrite()
+{
+    if (m_storage || m_journalEnabled) {
+        m_recordWriteTimer->start();
+    }
+}
+
+/**
+ * @brief 清空逐条脏标记
+ *
+ * 完整快照已包含全部记录时调用
+ */
+void NoteManager::clearDirtyRecords()
+{
+    m_dirtyNoteIds.clear();
+    m_removedNoteIds.clear();
+    m_dirtyCategoryIds.clear();
+    m_removedCategoryIds.clear();
+    m_recordWriteTimer->stop();
+}
+
+/**
+ * @brief 只把变化的记录写入存储后端或追加到写前日志
+ * @return 写入成功返回 true；失败时保留脏标记，下次再写
  *
  * 知识点：
- * - Lambda 捕获 this 和 note 指针
- * - 信号转发模式
+ * - 一条笔记无论修改多少次，这里只序列化一次
+ * - 修改一条笔记只写入这一条记录，与笔记总数无关
  */
-void NoteManager::connectNoteSignals(Note *note)
+bool NoteManager::writeDirtyRecords()
 {
-    connect(note, &Note::noteModified, this, [this, note]() {
-        setDirty(true);
-        emit noteModified(note);
+    m_recordWriteTimer->stop();
+
+    if (m_storage) {
+        QList<NoteRecord> notes;
+        for (const QString &id : std::as_const(m_dirtyNoteIds)) {
+            const int row = m_notes.rowOf(id);
+            if (row >= 0) {
+                notes.append(m_notes.record(row));
+            }
+        }
+        QList<CategoryRecord> categories;
+        for (const QString &id : std::as_const(m_dirtyCategoryIds)) {
+            if (Category *cat = m_categories.value(id, nullptr)) {
+                categories.append(cat->toRecord());
+            }
+        }
+        if (!openStorage()
+                || !m_storage->saveChanges(notes, m_removedNoteIds.values(),
+                                           categories, m_removedCategoryIds.values())) {
+            return false;
+        }
+        clearDirtyRecords();
+        return true;
+    }
+
+    if (!m_journalEnabled) {
+        return true;
+    }
+
+    for (const QString &id : std::as_const(m_removedNoteIds)) {
+        m_journal->appendNoteRemoval(id);
+    }
+    for (const QString &id : std::as_const(m_dirtyNoteIds)) {
+        const int row = m_notes.rowOf(id);
+        if (row >= 0) {
+            m_journal->appendNote(m_notes.record(row).toJson());
+        }
+    }
+    for (const QString &id : std::as_const(m_removedCategoryIds)) {
+        m_journal->appendCategoryRemoval(id);
+    }
+    for (const QString &id : std::as_const(m_dirtyCategoryIds)) {
+        if (Category *cat = m_categories.value(id, nullptr)) {
+            m_journal->appendCategory(cat->toJson());
+        }
+    }
+
+    m_dirtyNoteIds.clear();
+    m_removedNoteIds.clear();
+    m_dirtyCategoryIds.clear();
+    m_removedCategoryIds.clear();
+    return true;
+}
+
+/**
+ * @brief 丢弃全文索引，下次搜索时重新建立
+ */
+void NoteManager::resetSearchIndex()
+{
+    cancelSearch();
+    m_searchIndex->clear();
+    m_searchIndexBuilt = false;
+    m_staleSearchIds.clear();
+    m_provisionalSearchIds.clear();
+    m_searchBuildPending = false;
+    m_savedSearchGeneration = std::numeric_limits<quint64>::max();
+}
+
+/**
+ * @brief 让全文索引与内存数据一致
+ *
+ * 索引既没有从文件读入、也没有在后台建好时，在这里索引全部笔记；
+ * 之后只处理上次搜索以来修改过的笔记，
+ * 编辑器每次按键只在集合中记一笔，真正的分词推迟到下一次搜索。
+ *
+ * 后台校验期间先用直接读入的索引文件回答查询，不等校验完成：
+ * 只有还没有任何结果时才等待第一个结果（读入索引文件，没有文件时是完整建立的索引）。
+ * 这期间重新索引过的笔记记下来，换上校验后的索引时再重新索引一次
+ */
+void NoteManager::updateSearchIndex() const
+{
+    if (m_searchBuildPending) {
+        adoptPreparedSearchIndex();
+        if (!m_searchIndexBuilt) {
+            m_searchBuildWatcher->future().resultAt(0);
+            adoptPreparedSearchIndex();
+        }
+    }
+
+    if (!m_searchIndexBuilt) {
+        for (int row = 0; row < m_notes.size(); ++row) {
+            indexNote(row);
+        }
+        m_searchIndexBuilt = true;
+        m_staleSearchIds.clear();
+        return;
+    }
+
+    for (const QString &id : std::as_const(m_staleSearchIds)) {
+        const int row = m_notes.rowOf(id);
+        if (row >= 0) {
+            indexNote(row);
+        } else {
+            m_searchIndex->removeNote(id);
+        }
+    }
+    if (m_searchBuildPending) {
+        m_provisionalSearchIds += m_staleSearchIds;
+    }
+    m_staleSearchIds.clear();
+}
+
+/**
+ * @brief 索引（或重新索引）一行笔记
+ * @param row 行号
+ *
+ * 分词和子串验证都使用笔记表缓存的纯文本，索引与笔记表共享同一份字符串；
+ * 按需加载的正文经 LRU 缓存读取，不会为了指纹和纯文本各读一次
+ */
+void NoteManager::indexNote(int row) const
+{
+    const NoteRecord record = m_notes.record(row);
+    const QString content = m_notes.content(row);
+    m_searchIndex->addNote(record, m_notes.plainText(row), searchMetadata(record),
+                           searchFingerprint(record), searchContentHash(content));
+}
+
+/**
+ * @brief 解析搜索框中的查询，并把分类名称换成分类ID
+ * @param text 用户输入
+ * @return 解析结果；category: 和 -category: 匹配名称（不区分大小写）或ID相同的分类及其所有子分类
+ */
+SearchQuery NoteManager::parseSearchQuery(const QString &text) const
+{
+    SearchQuery query = SearchQuery::parse(text);
+    query.categoryIds = categoryIdsNamed(query.category);
+    query.excludedCategoryIds = categoryIdsNamed(query.excludedCategory);
+    return query;
+}
+
+/**
+ * @brief 按名称或ID查找分类，连同所有子分类
+ * @param name 分类名称（不区分大小写）或分类ID
+ * @return 分类ID列表；name 为空时返回空列表
+ */
+QStringList NoteManager::categoryIdsNamed(const QString &name) const
+{
+    QStringList ids;
+    if (name.isEmpty()) {
+        return ids;
+    }
+
+    QStringList pending;
+    for (Category *category : m_categories) {
+        if (category->id() == name || category->name().compare(name, Qt::CaseInsensitive) == 0) {
+            pending.append(category->id());
+        }
+    }
+    // 广度优先加入子分类
+    QSet<QString> seen;
+    while (!pending.isEmpty()) {
+        const QString id = pending.takeFirst();
+        if (seen.contains(id)) {
+            continue;
+        }
+        seen.insert(id);
+        ids.append(id);
+        for (Category *child : getChildCategories(id)) {
+            pending.append(child->id());
+        }
+    }
+    return ids;
+}
+
+/**
+ * @brief 全文索引文件路径：与数据文件同名、扩展名为 .searchindex
+ */
+QString NoteManager::searchIndexPath() const
+{
+    const QFileInfo info(m_dataFilePath);
+    return info.dir().filePath(info.completeBaseName() + QLatin1String(kSearchIndexSuffix));
+}
+
+/**
+ * @brief 加载数据后在后台准备全文索引
+ *
+ * 知识点：
+ * - 读入和校验索引文件放在工作线程中，不阻塞启动
+ * - QFutureInterface 先后送出两个结果：直接读入的索引文件和校验后的索引，
+ *   QFutureWatcher 每个结果都发出 resultReadyAt()
+ * - 工作线程只使用笔记记录的副本（按需加载的正文直接从数据源读取），不接触笔记表
+ * - 准备期间修改或删除的笔记记在 m_staleSearchIds 中，换上新索引后再重新索引
+ */
+void NoteManager::loadSearchIndex()
+{
+    QList<NoteRecord> records;
+    records.reserve(m_notes.size());
+    for (int row = 0; row < m_notes.size(); ++row) {
+        records.append(m_notes.record(row));
+    }
+    m_staleSearchIds.clear();
+    m_provisionalSearchIds.clear();
+    m_adoptedSearchResults = 0;
+    m_searchBuildPending = true;
+
+    QFutureInterface<PreparedSearchIndex> promise;
+    promise.reportStarted();
+    m_searchBuildWatcher->setFuture(promise.future());
+    const QString path = searchIndexPath();
+    QtConcurrent::run([promise, path, records]() mutable {
+        prepareSearchIndex(promise, path, records);
+        promise.reportFinished();
     });
 }
 
 /**
- * @brief 连接分类信号
- * @param category 分类对象指针
+ * @brief 准备全文索引（在工作线程中调用）
+ * @param promise 送出结果：读入索引文件后先送出一次（未校验），校验完再送出一次
+ * @param path 索引文件路径
+ * @param records 笔记记录的副本
+ *
+ * 有可用的索引文件时先比较元数据指纹（不读取正文）：
+ * 指纹相同、修改时间又早于索引文件对应的时间的笔记直接保留；
+ * 指纹相同但之后修改过的才读取正文比较散列；其余的就地重新索引。
+ * 数据中已没有的笔记从索引中移除；没有索引文件时为全部笔记建立索引
  */
-void NoteManager::connectCategorySignals(Category *category)
+void NoteManager::prepareSearchIndex(QFutureInterface<PreparedSearchIndex> &promise,
+                                     const QString &path, const QList<NoteRecord> &records)
 {
-    connect(category, &Category::categoryModified, this, [this, category]() {
-        setDirty(true);
-        emit categoryModified(category);
+    PreparedSearchIndex prepared;
+    SearchIndex &index = prepared.index;
+    const bool loaded = index.load(path);
+    if (loaded) {
+        promise.reportResult(prepared);
+    }
+    const quint64 loadedGeneration = index.generation();
+    const QDateTime indexedAt = index.indexedAt();
+
+    QSet<QString> ids;
+    ids.reserve(records.size());
+    for (const NoteRecord &record : records) {
+        ids.insert(record.id);
+        const quint64 fingerprint = searchFingerprint(record);
+        const bool sameMetadata = loaded && index.fingerprint(record.id) == fingerprint;
+        if (sameMetadata && indexedAt.isValid() && record.updatedAt < indexedAt) {
+            continue;
+        }
+        const QString content = record.loadContent();
+        const quint64 contentHash = searchContentHash(content);
+        if (!sameMetadata || index.contentHash(record.id) != contentHash) {
+            index.addNote(record, NoteRecord::plainTextFromHtml(content),
+                          searchMetadata(record), fingerprint, contentHash);
+        }
+    }
+    const QStringList indexedIds = index.noteIds();
+    for (const QString &id : indexedIds) {
+        if (!ids.contains(id)) {
+            index.removeNote(id);
+        }
+    }
+
+    prepared.upToDate = loaded && index.generation() == loadedGeneration;
+    prepared.validated = true;
+    promise.reportResult(prepared);
+}
+
+/**
+ * @brief 后台送出了一个准备好的索引：换上它，校验完成后有变化时写入索引文件
+ */
+void NoteManager::onSearchIndexPrepared()
+{
+    adoptPreparedSearchIndex();
+    if (!m_searchBuildPending) {
+        saveSearchIndex();
+    }
+}
+
+/**
+ * @brief 换上后台最新送出的索引（没有新结果时什么也不做）
+ *
+ * 未校验的索引只用来回答查询，不写回文件；换上校验后的索引时，
+ * 期间在未校验索引上重新索引过的笔记重新记为过期，下次搜索时再重新索引。
+ * 准备期间数据文件可能已经重写，正文一律改为引用笔记表中最新的内容或位置。
+ * 纯文本在两边共享：工作线程重新索引时算好的放进笔记表的缓存，
+ * 笔记表已经缓存的交给索引验证子串；准备期间修改过的笔记稍后重新索引，跳过
+ */
+void NoteManager::adoptPreparedSearchIndex() const
+{
+    if (!m_searchBuildPending) {
+        return;
+    }
+    const QFuture<PreparedSearchIndex> future = m_searchBuildWatcher->future();
+    const int count = future.resultCount();
+    if (count <= m_adoptedSearchResults) {
+        return;
+    }
+    m_adoptedSearchResults = count;
+    const PreparedSearchIndex prepared = future.resultAt(count - 1);
+    *m_searchIndex = prepared.index;
+    m_searchIndexBuilt = true;
+    if (prepared.validated) {
+        m_searchBuildPending = false;
+        m_staleSearchIds += m_provisionalSearchIds;
+        m_provisionalSearchIds.clear();
+    }
+    m_savedSearchGeneration = prepared.upToDate ? m_searchIndex->generation()
+                                                : std::numeric_limits<quint64>::max();
+
+    for (int row = 0; row < m_notes.size(); ++row) {
+        const QString id = m_notes.id(row);
+        if (m_notes.isContentLoaded(row)) {
+            m_searchIndex->setContent(id, m_notes.content(row), NoteContentRef());
+        } else {
+            m_searchIndex->setContent(id, QString(), m_notes.record(row).contentRef);
+        }
+        if (m_staleSearchIds.contains(id) || m_provisionalSearchIds.contains(id)) {
+            continue;
+        }
+        const QString cached = m_notes.cachedPlainText(row);
+        if (!cached.isNull()) {
+            m_searchIndex->setPlainText(id, cached);
+        } else {
+            m_notes.cachePlainText(row, m_searchIndex->plainText(id));
+        }
+    }
+}
+
+/**
+ * @brief 在后台把全文索引写入索引文件
+ *
+ * 每次写入都要序列化整个索引，因此不随每次保存写入，
+ * 只在后台准备好索引、日志合并成功后和退出时调用，两次之间的修改下次启动时由指纹校验找出来。
+ * 写入的是索引的副本（隐式共享），GUI 线程可以继续修改索引；
+ * 索引没有变化或还在后台校验时跳过，上一次写入尚未结束时先等它完成。
+ * 文件中记下复制索引时的时间，此前修改的笔记下次启动时只比较元数据指纹
+ */
+void NoteManager::saveSearchIndex()
+{
+    if (!m_searchIndexBuilt || m_searchBuildPending) {
+        return;
+    }
+    m_searchIndexSave.waitForFinished();
+    updateSearchIndex();
+    if (m_searchIndex->generation() == m_savedSearchGeneration) {
+        return;
+    }
+
+    m_savedSearchGeneration = m_searchIndex->generation();
+    const SearchIndex snapshot(*m_searchIndex);
+    const QDateTime indexedAt = QDateTime::currentDateTime();
+    const QString path = searchIndexPath();
+    m_searchIndexSave = QtConcurrent::run([snapshot, indexedAt, path]() {
+        snapshot.save(path, indexedAt);
     });
 }
+
+/**
+ * @brief 对命中结果排序并截取前 limit 条
+ * @param hits 全文索引的命中（带文本相关度）
+ * @param limit 最多返回的数量
+ * @param boosted 是否加上新近度和置顶加成（为 false 时只按命中分数排序）
+ * @return 按最终得分从高到低排序的笔记ID
+ *
+ * 知识点：
+ * - 最终得分 = 文本相关度 ×（1 + 新近度加成）× 置顶加成，新近度按修改时间指数衰减
+ * - 用大小为 limit 的最小堆只保留得分最高的 limit 条，O(n log K)，不对全部命中排序
+ */
+QStringList NoteManager::rankSearchHits(const QVector<SearchIndex::Hit> &hits, int limit,
+                                        bool boosted) const
+{
+    using Scored = std::pair<double, int>;
+    // 以“分数更高”为比较条件，堆顶是当前保留结果中的最低分
+    auto higher = [](const Scored &a, const Scored &b) { return a.first > b.first; };
+    std::priority_queue<Scored, std::vector<Scored>, decltype(higher)> heap(higher);
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (const SearchIndex::Hit &hit : hits) {
+        const int row = m_notes.rowOf(hit.noteId);
+        if (row < 0 || limit <= 0) {
+            continue;
+        }
+        double score = hit.score;
+        if (boosted) {
+            const double ageDays = qMax<qint64>(0, now - m_notes.updatedMSecs(row)) / 86400000.0;
+            score *= 1.0 + kRecencyBoost * std::exp2(-ageDays / kRecencyHalfLifeDays);
+            if (m_notes.isPinned(row)) {
+                score *= kPinnedBoost;
+            }
+        }
+
+        if (int(heap.size()) < limit) {
+            heap.push(Scored(score, row));
+        } else if (score > heap.top().first) {
+            heap.pop();
+            heap.push(Scored(score, row));
+        }
+    }
+
+    // 堆顶是最低分，倒序取出
+    QStringList result;
+    result.reserve(int(heap.size()));
+    while (!heap.empty()) {
+        result.prepend(m_notes.id(heap.top().second));
+        heap.pop();
+    }
+    return result;
+}
+
+/**
+ * @brief 后台搜索送回了一批或多批命中
+ * @param begin 第一个结果的序号
+ * @param end 最后一个结果之后的序号
+ *
+ * 笔记可能在查询期间被删除，只送出仍然存在的笔记。
+ * 全部命中都留下来参与最后的排序，但送给界面的部分结果合计不超过 limit 条，
+ * 界面的工作量与命中总数无关
+ */
+void NoteManager::onSearchResultsReady(int begin, int end)
+{
+    if (m_searchWatcher->isCanceled()) {
+        return;
+    }
+
+    QStringList noteIds;
+    for (int i = begin; i < end; ++i) {
+        const QVector<SearchIndex::Hit> batch = m_searchWatcher->resultAt(i);
+        for (const SearchIndex::Hit &hit : batch) {
+            if (m_streamedHitCount >= m_searchLimit) {
+                break;
+            }
+            if (m_notes.contains(hit.noteId)) {
+                noteIds.append(hit.noteId);
+                ++m_streamedHitCount;
+            }
+        }
+        m_searchHits += batch;
+    }
+    if (!noteIds.isEmpty()) {
+        emit searchResultsAvailable(noteIds);
+    }
+}
+
+/**
+ * @brief 后台搜索完成，排序后发出最终结果
+ *
+ * 查询期间索引没有变化时，把副本（带有这次查询的缓存）换回来，
+ * 下一次追加字符的查询仍然可以在这次的结果中筛选
+ */
+void NoteManager::onSearchFinished()
+{
+    if (m_searchWatcher->isCanceled() || !m_searchSnapshot) {
+        return;
+    }
+
+    if (m_searchSnapshot->generation() == m_searchIndex->generation()) {
+        *m_searchIndex = *m_searchSnapshot;
+    }
+    m_searchSnapshot.clear();
+
+    const QStringList ranked = rankSearchHits(m_searchHits, m_searchLimit,
+                                              m_searchMode != FuzzyTitleSearch);
+    m_searchHits.clear();
+    emit searchFinished(ranked);
+}
+
+/**
+ * @brief 打开存储后端（已打开时直接返回）
+ * @return 后端可用返回 true
+ */
+bool NoteManager::openStorage()
+{
+    return m_storage->isOpen() || m_storage->open(m_dataFilePath);
+}
+
+/**
+ * @brief 存储后端中的数据是否与内存一致（可以直接走索引查询）
+ * @return 一致返回 true
+ */
+bool NoteManager::isStorageInSync() const
+{
+    return m_storage && m_isLoaded && m_storage->isOpen()
+            && m_dirtyNoteIds.isEmpty() && m_removedNoteIds.isEmpty();
+}
+
+/**
+ * @brief 过滤掉查询结果中内存里已不存在的笔记
+ * @param ids 笔记ID列表
+ * @return 仍然存在的笔记ID（保持查询顺序）
+ */
+QStringList NoteManager::existingNoteIds(const QStringList &ids) const
+{
+    QStringList result;
+    result.reserve(ids.size());
+    for (const QString &id : ids) {
+        if (m_notes.contains(id)) {
+            result.append(id);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 收集全部笔记和分类的纯数据记录
+ * @param notes 输出笔记记录
+ * @param categories 输出分类记录
+ *
+ * 知识点：
+ * - 记录中的 QString 隐式共享，收集代价很低，可以安全地交给工作线程
+ */
+void NoteManager::collectRecords(QList<NoteRecord> *notes, QList<CategoryRecord> *categories) const
+{
+    notes->reserve(m_notes.size());
+    for (int row = 0; row < m_notes.size(); ++row) {
+        notes->append(m_notes.record(row));
+    }
+    categories->reserve(m_categories.size());
+    for (Category *cat : m_categories) {
+        categories->append(cat->toRecord());
+    }
+}
+
+/**
+ * @brief 同步写入完整快照
+ * @param path 文件路径
+ * @return 写入成功返回 true
+ *
+ * 写入默认数据文件后，旧日志中的记录都已包含在快照里，可以清空
+ */
+bool NoteManager::writeSnapshot(const QString &path)
+{
+    waitForPendingSaves();
+
+    const StorageFormat format = path == m_dataFilePath ? m_storageFormat : formatForPath(path);
+    QList<NoteRecord> notes;
+    QList<CategoryRecord> categories;
+    collectRecords(&notes, &categories);
+    if (m_storage && path == m_dataFilePath) {
+        if (!openStorage() || !m_storage->saveAll(notes, categories)) {
+            return false;
+        }
+    } else if (!writeDataFile(path, format, notes, categories, m_compressSnapshots)) {
+        return false;
+    }
+
+    if (path == m_dataFilePath) {
+        clearDirtyRecords();
+        if (m_journal->isOpen()) {
+            m_journal->reset();
+        } else {
+            NoteJournal::removeFiles(NoteJournal::journalPathFor(path));
+        }
+        rebindLazyContent();
+    }
+    return true;
+}
+
+/**
+ * @brief 让按需加载的笔记改为引用最新写出的快照
+ *
+ * 知识点：
+ * - 旧快照的 QSharedPointer 引用全部释放后，映射自动解除
+ * - 正文已加载（或已修改）的笔记不受影响
+ * - 全文索引也引用正文的位置，一起改为新快照，否则旧快照会一直被它持有
+ */
+void NoteManager::rebindLazyContent()
+{
+    if (!m_lazyContent || m_storageFormat != BinaryFormat) {
+        return;
+    }
+
+    QSharedPointer<BinarySnapshot> snapshot = QSharedPointer<BinarySnapshot>::create();
+    if (!snapshot->open(m_dataFilePath)) {
+        return;
+    }
+    for (int i = 0; i < snapshot->noteCount(); ++i) {
+        const NoteRecord record = snapshot->note(i, false);
+        const int row = m_notes.rowOf(record.id);
+        if (row >= 0) {
+            m_notes.rebindContent(row, record.contentRef);
+            if (!m_notes.isContentLoaded(row)) {
+                m_searchIndex->setContent(record.id, QString(), record.contentRef);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 插入（或覆盖）一条笔记
+ * @param record 笔记记录
+ * @return 插入成功返回 true；ID 为空的记录（损坏的快照或日志）被跳过
+ */
+bool NoteManager::insertNote(const NoteRecord &record)
+{
+    return m_notes.insert(record) >= 0;
+}
+
+/**
+ * @brief 从笔记表中删除一条笔记，并释放它的句柄
+ * @param id 笔记ID
+ */
+void NoteManager::removeNoteRow(const QString &id)
+{
+    const int row = m_notes.rowOf(id);
+    if (row >= 0) {
+        m_notes.remove(row);
+    }
+    closeNote(id);
+}
+
+/**
+ * @brief 插入（或覆盖）一个分类
+ * @param record 分类记录
+ */
+void NoteManager::insertCategory(const CategoryRecord &record)
+{
+    Category *cat = Category::fromRecord(record, this);
+    delete m_categories.take(cat->id());
+    connectCategorySignals(cat);
+    m_categories.insert(cat->id(), cat);
+}
+
+/**
+ * @brief 把一条日志记录应用到内存数据
+ * @param record 日志记录
+ *
+ * 记录按笔记/分类 ID 覆盖或删除，重复回放结果相同（幂等）
+ */
+void NoteManager::applyJournalRecord(const QJsonObject &record)
+{
+    const QString op = record["op"].toString();
+    if (op == "note") {
+        insertNote(NoteRecord::fromJson(record["data"].toObject()));
+    } else if (op == "noteRemoved") {
+        removeNoteRow(record["id"].toString());
+    } else if (op == "category") {
+        insertCategory(CategoryRecord::fromJson(record["data"].toObject()));
+    } else if (op == "categoryRemoved") {
+        delete m_categories.take(record["id"].toString());
+    }
+}
+
+/**
+ * @brief 为后台保存拍下当前数据的快照（GUI 线程）
+ * @return 在工作线程中执行的写入函数
+ *
+ * 知识点：
+ * - 在 GUI 线程收集记录（隐式共享，代价低），序列化和写盘在工作线程进行
+ * - 日志模式下这是一次合并：先封存日志，此后的修改写入新的活动日志
+ * - 记下当前修改序号，写完后据此判断期间是否又有新修改
+ */
+AsyncSaver::Job NoteManager::createSaveJob()
+{
+    m_saveIsCompaction = m_journalEnabled;
+    if (m_saveIsCompaction) {
+        writeDirtyRecords();
+        if (!m_journal->seal()) {
+            return []() { return false; };
+        }
+    } else {
+        m_savingNoteIds = m_dirtyNoteIds;
+        m_savingRemovedNoteIds = m_removedNoteIds;
+        clearDirtyRecords();
+    }
+    m_savingSerial = m_changeSerial;
+
+    const QString path = m_dataFilePath;
+    const StorageFormat format = m_storageFormat;
+    QList<NoteRecord> notes;
+    QList<CategoryRecord> categories;
+    collectRecords(&notes, &categories);
+
+    // 数据目录已存在时只重写变化的笔记文件
+    if (!m_saveIsCompaction && format == DirectoryFormat && NoteDirectory::isNoteDirectory(path)) {
+        const QSet<QString> changedIds = m_savingNoteIds;
+        const QSet<QString> removedIds = m_savingRemovedNoteIds;
+        return [path, notes, changedIds, removedIds, categories]() {
+            return NoteDirectory::writeChanges(path, notes, changedIds, removedIds, categories);
+        };
+    }
+
+    const bool compress = m_compressSnapshots;
+    return [path, format, notes, categories, compress]() {
+        return writeDataFile(path, format, notes, categories, compress);
+    };
+}
+
+/**
+ * @brief 后台保存结束（GUI 线程）
+ * @param ok 写入是否成功
+ *
+ * - 合并：快照写入成功才删除封存日志；失败时保留，下次加载会继续回放
+ * - 整文件保存：快照之后没有新修改才清除脏标记
+ */
+void NoteManager::onSaveFinished(bool ok)
+{
+    if (m_saveIsCompaction) {
+        if (ok) {
+            m_journal->discardSealed();
+            rebindLazyContent();
+            saveSearchIndex();
+        }
+        return;
+    }
+
+    if (!ok) {
+        // 未写入的记录重新标记为脏，下次保存时再写
+        for (const QString &id : std::as_const(m_savingNoteIds)) {
+            if (!m_removedNoteIds.contains(id)) {
+                m_dirtyNoteIds.insert(id);
+            }
+        }
+        for (const QString &id : std::as_const(m_savingRemovedNoteIds)) {
+            if (!m_dirtyNoteIds.contains(id) && !m_notes.contains(id)) {
+                m_removedNoteIds.insert(id);
+            }
+        }
+        m_savingNoteIds.clear();
+        m_savingRemovedNoteIds.clear();
+        emit saveFailed();
+        return;
+    }
+    m_savingNoteIds.clear();
+    m_savingRemovedNoteIds.clear();
+    NoteJournal::removeFiles(NoteJournal::journalPathFor(m_dataFilePath));
+    rebindLazyContent();
+    if (m_changeSerial == m_savingSerial) {
+        setDirty(false);
+    }
+    emit dataSaved();
+}
+
+/**
+ * @brief 在后台预取最近修改的笔记正文
+ *
+ * 知识点：
+ * - QtConcurrent::mapped() 在全局线程池中并行读取，可以随时 cancel()
+ * - 只预取正文尚未加载的笔记，总量不超过缓存容量的一部分，避免把缓存挤满
+ */
+void NoteManager::startPrefetch()
+{
+    if (!m_lazyContent) {
+        return;
+    }
+
+    NoteContentCache *cache = NoteContentCache::instance();
+    QVector<int> candidates;
+    for (int row = 0; row < m_notes.size(); ++row) {
+        if (!m_notes.isContentLoaded(row) && !cache->contains(m_notes.id(row))) {
+            candidates.append(row);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](int a, int b) {
+        return m_notes.updatedMSecs(a) > m_notes.updatedMSecs(b);
+    });
+
+    qint64 budget = cache->capacity() / kPrefetchCacheShare;
+    QList<NoteRecord> records;
+    for (int row : std::as_const(candidates)) {
+        budget -= m_notes.contentSize(row) * 2;
+        if (budget < 0) {
+            break;
+        }
+        records.append(m_notes.record(row));
+    }
+    if (records.isEmpty()) {
+        return;
+    }
+
+    m_prefetchWatcher->setFuture(QtConcurrent::mapped(records, prefetchContent));
+}
+
+/**
+ * @brief 预取结束，把读到的正文放入缓存
+ *
+ * 期间被修改或删除的笔记直接跳过
+ */
+void NoteManager::onPrefetchFinished()
+{
+    if (m_prefetchWatcher->isCanceled()) {
+        return;
+    }
+
+    const QList<QPair<QString, QString>> results = m_prefetchWatcher->future().results();
+    for (const QPair<QString, QString> &result : results) {
+        const int row = m_notes.rowOf(result.first);
+        if (row >= 0 && !m_notes.isContentLoaded(row)) {
+            NoteContentCache::instance()->insert(result.first, result.second);
+        }
+    }
+}
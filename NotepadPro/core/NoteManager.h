@@ -7,41 +7,129 @@
  * - QFile 文件操作
  * - QJsonDocument 数据持久化
  * - 信号槽机制
+ * - 笔记按列存储（NoteTable），变化通过一个带字段掩码的信号通知
  */
 
 #ifndef NOTEMANAGER_H
 #define NOTEMANAGER_H
 
 #include <QObject>
+#include <QDateTime>
+#include <QHash>
 #include <QList>
 #include <QMap>
+#include <QSet>
 #include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QFutureWatcher>
+#include <QPair>
+#include <QSharedPointer>
+#include <QVector>
 
-#include "Note.h"
 #include "Category.h"
+#include "AsyncSaver.h"
+#include "JsonStream.h"
+#include "NoteTable.h"
+#include "SearchIndex.h"
+
+class Note;
+class NoteJournal;
+class NoteStorage;
+class QTimer;
 
 /**
  * @class NoteManager
  * @brief 笔记和分类的管理器
  *
- * 负责笔记和分类的增删改查以及数据持久化
+ * 负责笔记和分类的增删改查以及数据持久化。
+ * 笔记以值的形式保存在 NoteTable 中，对外用笔记ID引用；
+ * 只有编辑中的笔记才通过 openNote() 创建 Note 句柄
  */
 class NoteManager : public QObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * @brief 数据文件格式
+     */
+    enum StorageFormat {
+        JsonFormat,     ///< JSON 文本（notepad_data.json）
+        BinaryFormat,   ///< 二进制快照，内存映射加载（notepad_data.npdb）
+        DirectoryFormat,///< 目录，清单 + 每条笔记一个文件（notepad_data/）
+        SqliteFormat    ///< SQLite 数据库，逐条写入（notepad_data.db）
+    };
+    Q_ENUM(StorageFormat)
+
+    /**
+     * @brief 搜索方式
+     */
+    enum SearchMode {
+        KeywordSearch,      ///< 关键词（按词和子串匹配标题与正文）
+        RegexSearch,        ///< 正则表达式（不区分大小写）
+        FuzzyTitleSearch    ///< 标题模糊匹配（容忍拼写错误和词序）
+    };
+    Q_ENUM(SearchMode)
+
+    /**
+     * @brief 笔记字段，notesModified() 用它说明哪些字段变了
+     */
+    enum NoteField {
+        TitleField      = 0x01,
+        ContentField    = 0x02,
+        CategoryField   = 0x04,
+        PinnedField     = 0x08,
+        UpdatedAtField  = 0x10
+    };
+    Q_DECLARE_FLAGS(NoteFields, NoteField)
+    Q_FLAG(NoteFields)
+
+    /// 搜索默认返回的最多结果数
+    static constexpr int DefaultSearchLimit = 200;
+
     static NoteManager* instance();
 
     // 笔记操作
-    Note* createNote(const QString &title = QString());
-    Note* getNote(const QString &id) const;
-    QList<Note*> getAllNotes() const;
-    QList<Note*> getNotesByCategory(const QString &categoryId) const;
-    QList<Note*> searchNotes(const QString &keyword) const;
+    QString createNote(const QString &title = QString(), const QString &categoryId = QString());
+    bool hasNote(const QString &id) const;
+    QStringList getAllNoteIds() const;
+    QStringList getNoteIdsByCategory(const QString &categoryId) const;
+    QStringList getNoteIdsPinnedFirst(const QString &categoryId = QString()) const;
+    QStringList getRecentNoteIds(int limit) const;
+    QStringList searchNotes(const QString &keyword, int limit = DefaultSearchLimit) const;
+    QStringList searchNotesByRegex(const QString &pattern, int limit = DefaultSearchLimit) const;
+    QStringList searchNotesFuzzy(const QString &title, int limit = DefaultSearchLimit) const;
+    void searchNotesAsync(const QString &keyword, SearchMode mode = KeywordSearch,
+                          int limit = DefaultSearchLimit);
+    void cancelSearch();
     bool deleteNote(const QString &id);
     int noteCount() const;
 
+    // 笔记字段（ID 不存在时返回空值）
+    NoteRecord noteRecord(const QString &id) const;
+    QString noteTitle(const QString &id) const;
+    QString noteContent(const QString &id) const;
+    QString noteCategoryId(const QString &id) const;
+    QDateTime noteCreatedAt(const QString &id) const;
+    QDateTime noteUpdatedAt(const QString &id) const;
+    bool isNotePinned(const QString &id) const;
+    bool isNoteContentLoaded(const QString &id) const;
+    QString notePlainText(const QString &id) const;
+    QString notePreview(const QString &id, int maxLength = NoteRecord::PreviewLength) const;
+
+    // 修改笔记（值真正改变时更新修改时间并发出 notesModified()）
+    void setNoteTitle(const QString &id, const QString &title);
+    void setNoteContent(const QString &id, const QString &content);
+    void setNoteCategoryId(const QString &id, const QString &categoryId);
+    void setNotePinned(const QString &id, bool pinned);
+
+    // 编辑中的笔记句柄
+    Note* openNote(const QString &id);
+    void closeNote(const QString &id);
+
     // 分类操作
     Category* createCategory(const QString &name);
     Category* getCategory(const QString &id) const;
@@ -50,11 +138,36 @@ public:
     QList<Category*> getChildCategories(const QString &parentId) const;
     bool deleteCategory(const QString &id);
     int categoryCount() const;
+    int noteCountInCategory(const QString &categoryId) const;
 
     // 数据持久化
     bool saveToFile(const QString &filePath = QString());
     bool loadFromFile(const QString &filePath = QString());
     QString defaultDataPath() const;
+    void waitForPendingSaves();
+    void saveSearchIndex();
+
+    // 导入/导出
+    bool exportToJson(const QString &filePath,
+                      const JsonStream::ProgressCallback &progress = JsonStream::ProgressCallback()) const;
+    bool importFromJson(const QString &filePath,
+                        const JsonStream::ProgressCallback &progress = JsonStream::ProgressCallback());
+
+    // 正文按需加载
+    bool isLazyContentEnabled() const;
+    void setLazyContentEnabled(bool enabled);
+
+    // 存储格式
+    StorageFormat storageFormat() const;
+    void setStorageFormat(StorageFormat format);
+
+    // 二进制快照正文压缩
+    bool isCompressionEnabled() const;
+    void setCompressionEnabled(bool enabled);
+
+    // 写前日志模式
+    bool isJournalEnabled() const;
+    void setJournalEnabled(bool enabled);
 
     // 数据状态
     bool isDirty() const;
@@ -62,9 +175,9 @@ public:
 
 signals:
     // 笔记相关信号
-    void noteCreated(Note *note);
+    void noteCreated(const QString &id);
     void noteDeleted(const QString &id);
-    void noteModified(Note *note);
+    void notesModified(const QStringList &ids, NoteManager::NoteFields fields);
     void notesChanged();
 
     // 分类相关信号
@@ -76,9 +189,24 @@ signals:
     // 数据状态信号
     void dataLoaded();
     void dataSaved();
+    void saveFailed();
     void dirtyChanged(bool dirty);
 
+    // 后台搜索信号
+    void searchResultsAvailable(const QStringList &noteIds);
+    void searchFinished(const QStringList &rankedNoteIds);
+
 private:
+    /**
+     * @brief 后台准备好的全文索引
+     */
+    struct PreparedSearchIndex
+    {
+        SearchIndex index;
+        bool upToDate = false;  // 与索引文件的内容相同，不需要重新写入
+        bool validated = false; // 已与笔记数据逐条校验；否则是直接读入的索引文件，可能有过期的笔记
+    };
+
     explicit NoteManager(QObject *parent = nullptr);
     ~NoteManager() override;
 
@@ -86,15 +214,109 @@ private:
     NoteManager(const NoteManager&) = delete;
     NoteManager& operator=(const NoteManager&) = delete;
 
-    void connectNoteSignals(Note *note);
     void connectCategorySignals(Category *category);
+    void touchNote(int row, NoteFields fields);
+
+    // 逐条脏记录
+    void markNoteDirty(const QString &id);
+    void markNoteRemoved(const QString &id);
+    void markCategoryDirty(const QString &id);
+    void markCategoryRemoved(const QString &id);
+    void scheduleRecordWrite();
+    void clearDirtyRecords();
+    bool writeDirtyRecords();
+
+    // 全文索引
+    void resetSearchIndex();
+    void updateSearchIndex() const;
+    void indexNote(int row) const;
+    QString searchIndexPath() const;
+    void loadSearchIndex();
+    void onSearchIndexPrepared();
+    void adoptPreparedSearchIndex() const;
+    static void prepareSearchIndex(QFutureInterface<PreparedSearchIndex> &promise,
+                                   const QString &path, const QList<NoteRecord> &records);
+    QStringList rankSearchHits(const QVector<SearchIndex::Hit> &hits, int limit,
+                                bool boosted = true) const;
+    SearchQuery parseSearchQuery(const QString &text) const;
+    QStringList categoryIdsNamed(const QString &name) const;
+    void onSearchResultsReady(int begin, int end);
+    void onSearchFinished();
+
+    // 存储后端
+    bool openStorage();
+    bool isStorageInSync() const;
+    QStringList existingNoteIds(const QStringList &ids) const;
+
+    QString dataPathFor(StorageFormat format) const;
+    void collectRecords(QList<NoteRecord> *notes, QList<CategoryRecord> *categories) const;
+    bool writeSnapshot(const QString &path);
+    void rebindLazyContent();
+    bool insertNote(const NoteRecord &record);
+    void removeNoteRow(const QString &id);
+    void insertCategory(const CategoryRecord &record);
+    void applyJournalRecord(const QJsonObject &record);
+    AsyncSaver::Job createSaveJob();
+    void onSaveFinished(bool ok);
+    void startPrefetch();
+    void onPrefetchFinished();
 
     static NoteManager *s_instance;
 
-    QMap<QString, Note*> m_notes;
+    NoteTable m_notes;
+    QHash<QString, Note*> m_noteHandles;    // openNote() 创建的句柄
     QMap<QString, Category*> m_categories;
     QString m_dataFilePath;
     bool m_isDirty;
+    bool m_isLoaded;
+    StorageFormat m_storageFormat;
+    bool m_lazyContent;
+    bool m_compressSnapshots;
+
+    // 自上次写入存储后变化的记录（每条只写一次，多次修改自动合并）
+    QSet<QString> m_dirtyNoteIds;
+    QSet<QString> m_removedNoteIds;
+    QSet<QString> m_dirtyCategoryIds;
+    QSet<QString> m_removedCategoryIds;
+
+    // 变化记录的写入目标：存储后端（如有）或写前日志
+    NoteStorage *m_storage;
+    NoteJournal *m_journal;
+    bool m_journalEnabled;
+    QTimer *m_recordWriteTimer;
+
+    // 后台保存：修改序号用于判断快照之后是否又有新修改
+    AsyncSaver *m_saver;
+    bool m_saveIsCompaction;
+    quint64 m_changeSerial;
+    quint64 m_savingSerial;
+    QSet<QString> m_savingNoteIds;
+    QSet<QString> m_savingRemovedNoteIds;
+
+    // 全文索引：加载数据后在后台读入索引文件并校验（没有时重新建立），之后只重新索引修改过的笔记；
+    // 校验期间先用读入的索引文件回答查询；索引文件只在准备好索引、日志合并成功后和退出时重写
+    SearchIndex *m_searchIndex;
+    mutable bool m_searchIndexBuilt;
+    mutable QSet<QString> m_staleSearchIds;
+    QFutureWatcher<PreparedSearchIndex> *m_searchBuildWatcher;
+    mutable bool m_searchBuildPending;
+    mutable int m_adoptedSearchResults;             // 已换上的后台结果数
+    mutable QSet<QString> m_provisionalSearchIds;   // 在未校验的索引上重新索引过的笔记
+    QFuture<void> m_searchIndexSave;
+    mutable quint64 m_savedSearchGeneration;    // 已写入索引文件的索引版本号
+
+    // 后台搜索：工作线程查询索引的副本，结果分批送回
+    QFutureWatcher<QVector<SearchIndex::Hit>> *m_searchWatcher;
+    QSharedPointer<SearchIndex> m_searchSnapshot;
+    QVector<SearchIndex::Hit> m_searchHits;
+    int m_searchLimit;
+    int m_streamedHitCount;             // 已作为部分结果送出的命中数（不超过 m_searchLimit）
+    SearchMode m_searchMode;
+
+    // 按需加载模式下在后台预取最近修改的笔记正文
+    QFutureWatcher<QPair<QString, QString>> *m_prefetchWatcher;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(NoteManager::NoteFields)
+
 #endif // NOTEMANAGER_H
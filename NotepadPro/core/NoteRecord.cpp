@@ -0,0 +1,304 @@
+/**
+ * @file NoteRecord.cpp
+ * @brief 笔记/分类纯数据记录实现
+ *
+ * 知识点：
+ * - QDateTime::toString(Qt::ISODate) ISO 格式日期字符串
+ * - QColor::name() 返回 "#RRGGBB" 格式字符串
+ * - 单遍扫描去掉 HTML 标签、解码字符实体，不使用正则表达式
+ */
+
+#include "NoteRecord.h"
+
+namespace {
+// 字符实体（&...;）的最大长度，超过时按普通字符处理
+const int kMaxEntityLength = 10;
+
+/**
+ * @brief 从 pos 开始的标签名是否为 name（不区分大小写）
+ */
+bool tagNameIs(const QString &html, int pos, int length, const char *name)
+{
+    int i = 0;
+    for (; i < length && name[i]; ++i) {
+        if (html.at(pos + i).toLower() != QLatin1Char(name[i])) {
+            return false;
+        }
+    }
+    return i == length && !name[i];
+}
+
+/**
+ * @brief pos 处是否为注释开头 "<!--"
+ */
+bool isCommentStart(const QString &html, int pos)
+{
+    return pos + 3 < html.size() && html.at(pos + 1) == QLatin1Char('!')
+            && html.at(pos + 2) == QLatin1Char('-') && html.at(pos + 3) == QLatin1Char('-');
+}
+
+/**
+ * @brief 标签是否会换行（前后的文字不属于同一个词）
+ */
+bool isBlockTag(const QString &html, int pos, int length)
+{
+    static const char *const blockTags[] = {
+        "br", "p", "div", "li", "ul", "ol", "tr", "td", "th", "table", "hr",
+        "h1", "h2", "h3", "h4", "h5", "h6", "pre", "blockquote"
+    };
+    for (const char *name : blockTags) {
+        if (tagNameIs(html, pos, length, name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 内容不是正文、需要整段跳过的标签
+ */
+bool isSkippedTag(const QString &html, int pos, int length)
+{
+    return tagNameIs(html, pos, length, "head") || tagNameIs(html, pos, length, "style")
+            || tagNameIs(html, pos, length, "script");
+}
+
+/**
+ * @brief 解码 pos 处的字符实体
+ * @param html HTML 文本，html[pos] 为 '&'
+ * @param codePoint 输出解码后的码点
+ * @return 实体的长度（含 & 和 ;），不是可识别的实体时返回 0
+ *
+ * 支持 &#123; &#x7b; 以及 QTextEdit 会生成的几个命名实体
+ */
+int decodeEntity(const QString &html, int pos, uint *codePoint)
+{
+    const int end = html.indexOf(QLatin1Char(';'), pos + 1);
+    if (end < 0 || end - pos > kMaxEntityLength) {
+        return 0;
+    }
+
+    const QString name = html.mid(pos + 1, end - pos - 1);
+    bool ok = false;
+    if (name.startsWith(QLatin1Char('#'))) {
+        const bool hex = name.size() > 1
+                && (name.at(1) == QLatin1Char('x') || name.at(1) == QLatin1Char('X'));
+        *codePoint = hex ? name.mid(2).toUInt(&ok, 16) : name.mid(1).toUInt(&ok, 10);
+        ok = ok && *codePoint > 0 && *codePoint <= 0x10ffff;
+    } else {
+        static const struct { const char *name; uint codePoint; } named[] = {
+            { "amp", '&' }, { "lt", '<' }, { "gt", '>' }, { "quot", '"' },
+            { "apos", '\'' }, { "nbsp", 0xa0 }
+        };
+        for (const auto &entity : named) {
+            if (name == QLatin1String(entity.name)) {
+                *codePoint = entity.codePoint;
+                ok = true;
+                break;
+            }
+        }
+    }
+    return ok ? end - pos + 1 : 0;
+}
+}
+
+/**
+ * @brief 获取正文
+ * @return 正文文本；按需加载的记录直接从数据源读取（不经过缓存，可在工作线程调用）
+ */
+QString NoteRecord::loadContent() const
+{
+    return contentRef.isValid() ? contentRef.load() : content;
+}
+
+/**
+ * @brief 获取正文长度（UTF-16 码元数），不需要真正读取正文
+ * @return 正文长度
+ */
+qint64 NoteRecord::contentSize() const
+{
+    return contentRef.isValid() ? contentRef.length : content.size();
+}
+
+/**
+ * @brief 从 HTML 正文提取纯文本
+ * @param html HTML 正文
+ * @return 去掉标签和样式表、解码字符实体、合并空白后的文本（搜索索引和预览共用）
+ *
+ * 知识点：
+ * - 一遍扫描同时完成去标签、解码实体和合并空白，不产生中间字符串
+ * - <head>/<style>/<script> 和注释中不是正文，整段跳过
+ * - 段落、换行等块级标签视为空白，前后两段的文字不会连在一起
+ */
+QString NoteRecord::plainTextFromHtml(const QString &html)
+{
+    QString text;
+    text.reserve(html.size() / 2);
+    bool pendingSpace = false;
+
+    // 连续空白合并为一个空格，开头和结尾的空白去掉（与 simplified() 相同）
+    auto append = [&text, &pendingSpace](uint codePoint) {
+        if (QChar::isSpace(codePoint)) {
+            pendingSpace = !text.isEmpty();
+            return;
+        }
+        if (pendingSpace) {
+            text += QLatin1Char(' ');
+            pendingSpace = false;
+        }
+        if (QChar::requiresSurrogates(codePoint)) {
+            text += QChar(QChar::highSurrogate(codePoint));
+            text += QChar(QChar::lowSurrogate(codePoint));
+        } else {
+            text += QChar(codePoint);
+        }
+    };
+
+    const int size = html.size();
+    int i = 0;
+    while (i < size) {
+        const QChar ch = html.at(i);
+
+        if (ch == QLatin1Char('<')) {
+            if (isCommentStart(html, i)) {
+                const int end = html.indexOf(QLatin1String("-->"), i + 4);
+                i = end < 0 ? size : end + 3;
+                continue;
+            }
+            const int close = html.indexOf(QLatin1Char('>'), i + 1);
+            if (close < 0) {
+                break;  // 未闭合的标签，剩余部分丢弃
+            }
+
+            int nameStart = i + 1;
+            const bool closing = nameStart < close && html.at(nameStart) == QLatin1Char('/');
+            if (closing) {
+                ++nameStart;
+            }
+            int nameEnd = nameStart;
+            while (nameEnd < close && html.at(nameEnd).isLetterOrNumber()) {
+                ++nameEnd;
+            }
+            const int nameLength = nameEnd - nameStart;
+
+            i = close + 1;
+            if (!closing && isSkippedTag(html, nameStart, nameLength)) {
+                const QString endTag = QLatin1String("</") + html.mid(nameStart, nameLength);
+                const int end = html.indexOf(endTag, i, Qt::CaseInsensitive);
+                const int endClose = end < 0 ? -1 : html.indexOf(QLatin1Char('>'), end);
+                i = endClose < 0 ? size : endClose + 1;
+            } else if (isBlockTag(html, nameStart, nameLength)) {
+                pendingSpace = !text.isEmpty();
+            }
+            continue;
+        }
+
+        if (ch == QLatin1Char('&')) {
+            uint codePoint = 0;
+            const int length = decodeEntity(html, i, &codePoint);
+            if (length > 0) {
+                append(codePoint);
+                i += length;
+                continue;
+            }
+        }
+
+        uint codePoint = ch.unicode();
+        if (ch.isHighSurrogate() && i + 1 < size && html.at(i + 1).isLowSurrogate()) {
+            codePoint = QChar::surrogateToUcs4(ch, html.at(i + 1));
+            ++i;
+        }
+        append(codePoint);
+        ++i;
+    }
+    return text;
+}
+
+/**
+ * @brief 从纯文本生成预览
+ * @param plainText plainTextFromHtml() 的结果
+ * @param maxLength 最大长度
+ * @return 纯文本预览，超长时截断并加上 "..."
+ */
+QString NoteRecord::previewFromPlainText(const QString &plainText, int maxLength)
+{
+    if (plainText.length() > maxLength) {
+        return plainText.left(maxLength) + "...";
+    }
+    return plainText;
+}
+
+/**
+ * @brief 从 HTML 正文生成纯文本预览
+ * @param html HTML 正文
+ * @param maxLength 最大长度
+ * @return 纯文本预览，超长时截断并加上 "..."
+ */
+QString NoteRecord::previewFromHtml(const QString &html, int maxLength)
+{
+    return previewFromPlainText(plainTextFromHtml(html), maxLength);
+}
+
+/**
+ * @brief 笔记记录序列化为 JSON 对象
+ * @return JSON 对象
+ */
+QJsonObject NoteRecord::toJson() const
+{
+    QJsonObject json;
+    json["id"] = id;
+    json["title"] = title;
+    json["content"] = loadContent();
+    json["categoryId"] = categoryId;
+    json["createdAt"] = createdAt.toString(Qt::ISODate);
+    json["updatedAt"] = updatedAt.toString(Qt::ISODate);
+    json["isPinned"] = isPinned;
+    return json;
+}
+
+/**
+ * @brief 从 JSON 对象解析笔记记录
+ * @param json JSON 对象
+ * @return 笔记记录
+ */
+NoteRecord NoteRecord::fromJson(const QJsonObject &json)
+{
+    NoteRecord record;
+    record.id = json["id"].toString();
+    record.title = json["title"].toString();
+    record.content = json["content"].toString();
+    record.categoryId = json["categoryId"].toString();
+    record.createdAt = QDateTime::fromString(json["createdAt"].toString(), Qt::ISODate);
+    record.updatedAt = QDateTime::fromString(json["updatedAt"].toString(), Qt::ISODate);
+    record.isPinned = json["isPinned"].toBool();
+    return record;
+}
+
+/**
+ * @brief 分类记录序列化为 JSON 对象
+ * @return JSON 对象
+ */
+QJsonObject CategoryRecord::toJson() const
+{
+    QJsonObject json;
+    json["id"] = id;
+    json["name"] = name;
+    json["color"] = color.name();
+    json["parentId"] = parentId;
+    return json;
+}
+
+/**
+ * @brief 从 JSON 对象解析分类记录
+ * @param json JSON 对象
+ * @return 分类记录
+ */
+CategoryRecord CategoryRecord::fromJson(const QJsonObject &json)
+{
+    CategoryRecord record;
+    record.id = json["id"].toString();
+    record.name = json["name"].toString();
+    record.color = QColor(json["color"].toString());
+    record.parentId = json["parentId"].toString();
+    return record;
+}
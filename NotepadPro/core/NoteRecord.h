@@ -0,0 +1,74 @@
+/**
+ * @file NoteRecord.h
+ * @brief 笔记/分类的纯数据记录
+ *
+ * 知识点：
+ * - 值类型（struct）与 QObject 的区别：可拷贝、无信号槽开销
+ * - QString 隐式共享：拷贝记录只增加引用计数
+ * - 存储格式与界面对象解耦
+ */
+
+#ifndef NOTERECORD_H
+#define NOTERECORD_H
+
+#include <QString>
+#include <QDateTime>
+#include <QColor>
+#include <QJsonObject>
+
+#include "NoteContentCache.h"
+
+/**
+ * @struct NoteRecord
+ * @brief 笔记的纯数据形式
+ *
+ * 各种存储格式（JSON、二进制快照、日志）读写的都是这个结构，
+ * 再由 NoteTable::insert()/NoteTable::record() 存入或取出笔记表。
+ * 按需加载模式下 content 为空，正文位置保存在 contentRef 中
+ */
+struct NoteRecord
+{
+    QString id;
+    QString title;
+    QString content;
+    QString categoryId;
+    QDateTime createdAt;
+    QDateTime updatedAt;
+    bool isPinned = false;
+    NoteContentRef contentRef;
+    QString preview;    // 纯文本预览（可选，加载时在工作线程预先计算）
+
+    // 预览的默认长度
+    static constexpr int PreviewLength = 100;
+
+    // 正文访问（按需加载时从数据源读取）
+    QString loadContent() const;
+    qint64 contentSize() const;
+
+    // HTML 转纯文本/预览（不访问 QObject，可在工作线程调用）
+    static QString plainTextFromHtml(const QString &html);
+    static QString previewFromPlainText(const QString &plainText, int maxLength = PreviewLength);
+    static QString previewFromHtml(const QString &html, int maxLength = PreviewLength);
+
+    // JSON 序列化
+    QJsonObject toJson() const;
+    static NoteRecord fromJson(const QJsonObject &json);
+};
+
+/**
+ * @struct CategoryRecord
+ * @brief 分类的纯数据形式
+ */
+struct CategoryRecord
+{
+    QString id;
+    QString name;
+    QColor color;
+    QString parentId;
+
+    // JSON 序列化
+    QJsonObject toJson() const;
+    static CategoryRecord fromJson(const QJsonObject &json);
+};
+
+#endif // NOTERECORD_H
@@ -0,0 +1,50 @@
+/**
+ * @file NoteStorage.h
+ * @brief 可替换的存储后端接口
+ *
+ * 知识点：
+ * - 纯虚接口把“数据存在哪里”与 NoteManager 的业务逻辑分开
+ * - 按记录增量写入，而不是每次重写整个文件
+ */
+
+#ifndef NOTESTORAGE_H
+#define NOTESTORAGE_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "NoteRecord.h"
+
+/**
+ * @class NoteStorage
+ * @brief 以记录为单位读写的存储后端（数据库等）
+ *
+ * 与文件格式不同，后端支持逐条更新和按条件查询。
+ * 一个实例只在创建它的线程中使用
+ */
+class NoteStorage
+{
+public:
+    virtual ~NoteStorage() = default;
+
+    // 打开/关闭
+    virtual bool open(const QString &path) = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+
+    // 读写
+    virtual bool load(QList<NoteRecord> *notes, QList<CategoryRecord> *categories) = 0;
+    virtual bool saveAll(const QList<NoteRecord> &notes,
+                         const QList<CategoryRecord> &categories) = 0;
+    virtual bool saveChanges(const QList<NoteRecord> &notes, const QStringList &removedNoteIds,
+                             const QList<CategoryRecord> &categories,
+                             const QStringList &removedCategoryIds) = 0;
+
+    // 查询（返回笔记ID；categoryId 为空表示全部笔记）
+    virtual QStringList noteIdsByCategory(const QString &categoryId) const = 0;
+    virtual QStringList noteIdsPinnedFirst(const QString &categoryId) const = 0;
+    virtual QStringList recentNoteIds(int limit) const = 0;
+};
+
+#endif // NOTESTORAGE_H
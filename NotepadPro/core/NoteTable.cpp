@@ -0,0 +1,479 @@
+/**
+ * @file NoteTable.cpp
+ * @brief 按列存储的笔记表实现
+ *
+ * 知识点：
+ * - 删除第 row 行：把最后一行的各列移到 row，再 removeLast()，同时修正 ID → 行号映射
+ * - std::move 移动隐式共享的 QString，只交换指针
+ * - 按需加载的正文经 NoteContentCache 读取，表中只保存位置
+ * - ID 的字符串形式只在 record()/id() 这些出口上生成
+ * - 分类ID只增不减地驻留：分类数量很少，删除分类后留下的句柄不值得回收
+ * - 分类行号列表同样用“最后一个填补空位”删除，每行记住自己在列表中的位置，O(1)
+ */
+
+#include "NoteTable.h"
+
+#include <limits>
+#include <utility>
+
+namespace {
+// 无效时间（JSON 中缺少时间戳等）在时间列中的取值
+const qint64 kInvalidTime = std::numeric_limits<qint64>::min();
+
+/**
+ * @brief 用最后一个元素覆盖第 row 个元素，再删除最后一个元素
+ */
+template <typename T>
+void moveLastInto(QVector<T> *column, int row)
+{
+    if (row != column->size() - 1) {
+        (*column)[row] = std::move(column->last());
+    }
+    column->removeLast();
+}
+}
+
+/**
+ * @brief 构造函数
+ */
+NoteTable::NoteTable()
+    : m_categoryIds(1)
+    , m_categoryRows(1)
+{
+}
+
+/**
+ * @brief 笔记数量
+ */
+int NoteTable::size() const
+{
+    return m_ids.size();
+}
+
+/**
+ * @brief 是否没有笔记
+ */
+bool NoteTable::isEmpty() const
+{
+    return m_ids.isEmpty();
+}
+
+/**
+ * @brief 笔记所在的行
+ * @param id 笔记ID
+ * @return 行号，不存在时返回 -1
+ *
+ * 行号在插入和删除后可能变化，只能在两次修改之间使用
+ */
+int NoteTable::rowOf(const QString &id) const
+{
+    return rowOf(NoteId::find(id));
+}
+
+/**
+ * @brief 笔记所在的行（二进制ID）
+ */
+int NoteTable::rowOf(const NoteId &id) const
+{
+    return m_rows.value(id, -1);
+}
+
+/**
+ * @brief 是否包含某条笔记
+ */
+bool NoteTable::contains(const QString &id) const
+{
+    return m_rows.contains(NoteId::find(id));
+}
+
+/**
+ * @brief 全部笔记ID（按行的顺序）
+ */
+QStringList NoteTable::ids() const
+{
+    QStringList result;
+    result.reserve(m_ids.size());
+    for (const NoteId &id : m_ids) {
+        result.append(id.toString());
+    }
+    return result;
+}
+
+/**
+ * @brief 预留空间，加载大量笔记前调用，避免各列反复扩容
+ * @param size 预计的笔记数
+ */
+void NoteTable::reserve(int size)
+{
+    m_rows.reserve(size);
+    m_ids.reserve(size);
+    m_titles.reserve(size);
+    m_contents.reserve(size);
+    m_contentRefs.reserve(size);
+    m_categoryHandles.reserve(size);
+    m_categoryPositions.reserve(size);
+    m_createdAt.reserve(size);
+    m_updatedAt.reserve(size);
+    m_pinned.reserve(size);
+    m_plainTexts.reserve(size);
+    m_previews.reserve(size);
+}
+
+/**
+ * @brief 清空表
+ */
+void NoteTable::clear()
+{
+    m_rows.clear();
+    m_ids.clear();
+    m_titles.clear();
+    m_contents.clear();
+    m_contentRefs.clear();
+    m_categoryHandles.clear();
+    m_categoryPositions.clear();
+    m_createdAt.clear();
+    m_updatedAt.clear();
+    m_pinned.clear();
+    m_plainTexts.clear();
+    m_previews.clear();
+    m_categoryIds.resize(1);
+    m_categoryIndex.clear();
+    m_categoryRows = QVector<QVector<int>>(1);
+}
+
+/**
+ * @brief 插入一条笔记，ID 已存在时覆盖原来的行
+ * @param record 笔记记录
+ * @return 笔记所在的行；ID 为空时不插入，返回 -1
+ */
+int NoteTable::insert(const NoteRecord &record)
+{
+    const NoteId id = NoteId::fromString(record.id);
+    if (id.isNull()) {
+        return -1;
+    }
+    int row = rowOf(id);
+    if (row < 0) {
+        row = m_ids.size();
+        m_rows.insert(id, row);
+        m_ids.append(id);
+        m_titles.append(record.title);
+        m_contents.append(record.content);
+        m_contentRefs.append(record.contentRef);
+        m_categoryHandles.append(internCategory(record.categoryId));
+        m_categoryPositions.append(0);
+        m_createdAt.append(toMSecs(record.createdAt));
+        m_updatedAt.append(toMSecs(record.updatedAt));
+        m_pinned.append(record.isPinned);
+        m_plainTexts.append(QString());
+        m_previews.append(record.preview);
+        linkCategory(row);
+        return row;
+    }
+
+    m_titles[row] = record.title;
+    m_contents[row] = record.content;
+    m_contentRefs[row] = record.contentRef;
+    unlinkCategory(row);
+    m_categoryHandles[row] = internCategory(record.categoryId);
+    linkCategory(row);
+    m_createdAt[row] = toMSecs(record.createdAt);
+    m_updatedAt[row] = toMSecs(record.updatedAt);
+    m_pinned[row] = record.isPinned;
+    m_plainTexts[row].clear();
+    m_previews[row] = record.preview;
+    return row;
+}
+
+/**
+ * @brief 删除一行，最后一行移到它的位置
+ * @param row 行号
+ */
+void NoteTable::remove(int row)
+{
+    const int last = m_ids.size() - 1;
+    unlinkCategory(row);
+    m_rows.remove(m_ids.at(row));
+    if (row != last) {
+        m_rows.insert(m_ids.last(), row);
+        m_categoryRows[m_categoryHandles.at(last)][m_categoryPositions.at(last)] = row;
+    }
+    moveLastInto(&m_ids, row);
+    moveLastInto(&m_titles, row);
+    moveLastInto(&m_contents, row);
+    moveLastInto(&m_contentRefs, row);
+    moveLastInto(&m_categoryHandles, row);
+    moveLastInto(&m_categoryPositions, row);
+    moveLastInto(&m_createdAt, row);
+    moveLastInto(&m_updatedAt, row);
+    moveLastInto(&m_pinned, row);
+    moveLastInto(&m_plainTexts, row);
+    moveLastInto(&m_previews, row);
+}
+
+/**
+ * @brief 取出一行的纯数据记录
+ * @param row 行号
+ * @return 笔记记录（按需加载的正文仍留在磁盘上，只带位置）
+ *
+ * 知识点：
+ * - QString 隐式共享，拷贝只增加引用计数，代价很低
+ */
+NoteRecord NoteTable::record(int row) const
+{
+    NoteRecord record;
+    record.id = m_ids.at(row).toString();
+    record.title = m_titles.at(row);
+    record.content = m_contents.at(row);
+    record.contentRef = m_contentRefs.at(row);
+    record.preview = m_previews.at(row);
+    record.categoryId = categoryId(row);
+    record.createdAt = createdAt(row);
+    record.updatedAt = updatedAt(row);
+    record.isPinned = m_pinned.at(row);
+    return record;
+}
+
+// ========== 读取 ==========
+
+QString NoteTable::id(int row) const { return m_ids.at(row).toString(); }
+NoteId NoteTable::key(int row) const { return m_ids.at(row); }
+QString NoteTable::title(int row) const { return m_titles.at(row); }
+QString NoteTable::categoryId(int row) const { return m_categoryIds.at(m_categoryHandles.at(row)).toString(); }
+int NoteTable::categoryHandle(int row) const { return int(m_categoryHandles.at(row)); }
+QDateTime NoteTable::createdAt(int row) const { return fromMSecs(m_createdAt.at(row)); }
+QDateTime NoteTable::updatedAt(int row) const { return fromMSecs(m_updatedAt.at(row)); }
+qint64 NoteTable::updatedMSecs(int row) const { return m_updatedAt.at(row); }
+bool NoteTable::isPinned(int row) const { return m_pinned.at(row); }
+
+/**
+ * @brief 获取笔记正文
+ * @param row 行号
+ * @return HTML 内容
+ *
+ * 按需加载模式下正文不常驻内存，首次访问时经 LRU 缓存从磁盘读取
+ */
+QString NoteTable::content(int row) const
+{
+    const NoteContentRef &ref = m_contentRefs.at(row);
+    if (ref.isValid()) {
+        return NoteContentCache::instance()->content(m_ids.at(row).toString(), ref);
+    }
+    return m_contents.at(row);
+}
+
+/**
+ * @brief 正文是否已在内存中
+ * @return 已加载（或是新建笔记）返回 true
+ */
+bool NoteTable::isContentLoaded(int row) const
+{
+    return !m_contentRefs.at(row).isValid();
+}
+
+/**
+ * @brief 正文长度（UTF-16 码元数），不需要真正读取正文
+ */
+qint64 NoteTable::contentSize(int row) const
+{
+    const NoteContentRef &ref = m_contentRefs.at(row);
+    return ref.isValid() ? ref.length : m_contents.at(row).size();
+}
+
+/**
+ * @brief 获取正文的纯文本
+ * @param row 行号
+ * @return 去掉标签、解码字符实体、合并空白后的正文
+ *
+ * 第一次调用时从 HTML 计算并缓存，只有 setContent() 会让缓存失效
+ */
+QString NoteTable::plainText(int row) const
+{
+    QString &cached = m_plainTexts[row];
+    if (cached.isNull()) {
+        cached = NoteRecord::plainTextFromHtml(content(row));
+    }
+    return cached;
+}
+
+/**
+ * @brief 已缓存的正文纯文本
+ * @return 还没有计算过时返回空字符串（isNull()），不会读取正文
+ */
+QString NoteTable::cachedPlainText(int row) const
+{
+    return m_plainTexts.at(row);
+}
+
+/**
+ * @brief 放入别处（如后台建索引时）已经算好的纯文本
+ * @param row 行号
+ * @param plainText 由当前正文得到的纯文本
+ *
+ * 已有缓存时保持不变；与调用方共享同一份字符串，不复制
+ */
+void NoteTable::cachePlainText(int row, const QString &plainText) const
+{
+    QString &cached = m_plainTexts[row];
+    if (cached.isNull()) {
+        cached = plainText;
+    }
+}
+
+/**
+ * @brief 获取正文预览
+ * @param row 行号
+ * @param maxLength 最大长度
+ * @return 纯文本预览；默认长度的预览会被缓存（JSON 加载时已在工作线程预先计算）
+
+ */
+QString NoteTable::preview(int row, int maxLength) const
+{
+    if (maxLength != NoteRecord::PreviewLength) {
+        return NoteRecord::previewFromPlainText(plainText(row), maxLength);
+    }
+    QString &cached = m_previews[row];
+    if (cached.isNull()) {
+        cached = NoteRecord::previewFromPlainText(plainText(row));
+    }
+    return cached;
+}
+
+// ========== 修改 ==========
+
+void NoteTable::setTitle(int row, const QString &title) { m_titles[row] = title; }
+void NoteTable::setCategoryId(int row, const QString &categoryId)
+{
+    unlinkCategory(row);
+    m_categoryHandles[row] = internCategory(categoryId);
+    linkCategory(row);
+}
+void NoteTable::setPinned(int row, bool pinned) { m_pinned[row] = pinned; }
+void NoteTable::setUpdatedAt(int row, const QDateTime &updatedAt) { m_updatedAt[row] = toMSecs(updatedAt); }
+
+/**
+ * @brief 设置正文
+ * @param row 行号
+ * @param content 新内容
+ *
+ * 正文改为常驻内存，纯文本和预览缓存失效
+ */
+void NoteTable::setContent(int row, const QString &content)
+{
+    m_contents[row] = content;
+    m_plainTexts[row].clear();
+    m_previews[row].clear();
+    if (m_contentRefs.at(row).isValid()) {
+        m_contentRefs[row] = NoteContentRef();
+        NoteContentCache::instance()->remove(m_ids.at(row).toString());
+    }
+}
+
+/**
+ * @brief 把按需加载的正文指向新的数据源
+ * @param row 行号
+ * @param ref 新位置
+ *
+ * 保存出新的快照后调用，使旧快照文件可以被释放；正文已加载的笔记不受影响
+ */
+void NoteTable::rebindContent(int row, const NoteContentRef &ref)
+{
+    if (m_contentRefs.at(row).isValid()) {
+        m_contentRefs[row] = ref;
+    }
+}
+
+/**
+ * @brief 查找分类ID的句柄（不驻留新的分类ID）
+ * @param categoryId 分类ID
+ * @return 为空时返回 0；没有笔记用过的分类返回 -1，不会与任何行相等
+ *
+ * 按分类过滤时先调用一次，之后逐行比较整数句柄
+ */
+int NoteTable::findCategoryHandle(const QString &categoryId) const
+{
+    if (categoryId.isEmpty()) {
+        return 0;
+    }
+    const quint32 handle = m_categoryIndex.value(NoteId::find(categoryId), 0);
+    return handle != 0 ? int(handle) : -1;
+}
+
+/**
+ * @brief 某个分类的全部行
+ * @param handle findCategoryHandle() 返回的句柄（0 为未分类）
+ * @return 行号（无序）；句柄无效时返回空列表
+ */
+QVector<int> NoteTable::rowsInCategory(int handle) const
+{
+    return handle >= 0 ? m_categoryRows.at(handle) : QVector<int>();
+}
+
+/**
+ * @brief 某个分类的笔记数
+ * @param handle findCategoryHandle() 返回的句柄（0 为未分类）
+ */
+int NoteTable::countInCategory(int handle) const
+{
+    return handle >= 0 ? m_categoryRows.at(handle).size() : 0;
+}
+
+/**
+ * @brief 驻留分类ID
+ * @param categoryId 分类ID
+ * @return 分类句柄（为空时返回 0）
+ */
+quint32 NoteTable::internCategory(const QString &categoryId)
+{
+    const NoteId id = NoteId::fromString(categoryId);
+    if (id.isNull()) {
+        return 0;
+    }
+    quint32 handle = m_categoryIndex.value(id, 0);
+    if (handle == 0) {
+        handle = quint32(m_categoryIds.size());
+        m_categoryIds.append(id);
+        m_categoryIndex.insert(id, handle);
+        m_categoryRows.append(QVector<int>());
+    }
+    return handle;
+}
+
+/**
+ * @brief 把一行加入它所属分类的行号列表
+ */
+void NoteTable::linkCategory(int row)
+{
+    QVector<int> &rows = m_categoryRows[m_categoryHandles.at(row)];
+    m_categoryPositions[row] = rows.size();
+    rows.append(row);
+}
+
+/**
+ * @brief 把一行从它所属分类的行号列表中移除（列表最后一项填补空位）
+ */
+void NoteTable::unlinkCategory(int row)
+{
+    QVector<int> &rows = m_categoryRows[m_categoryHandles.at(row)];
+    const int position = m_categoryPositions.at(row);
+    const int moved = rows.last();
+    rows[position] = moved;
+    m_categoryPositions[moved] = position;
+    rows.removeLast();
+}
+
+/**
+ * @brief 时间转换为时间列中的毫秒数
+ */
+qint64 NoteTable::toMSecs(const QDateTime &dateTime)
+{
+    return dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : kInvalidTime;
+}
+
+/**
+ * @brief 时间列中的毫秒数转换为时间
+ */
+QDateTime NoteTable::fromMSecs(qint64 msecs)
+{
+    return msecs == kInvalidTime ? QDateTime() : QDateTime::fromMSecsSinceEpoch(msecs);
+}
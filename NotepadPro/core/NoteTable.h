@@ -0,0 +1,110 @@
+/**
+ * @file NoteTable.h
+ * @brief 按列存储的笔记表
+ *
+ * 知识点：
+ * - 列式存储（struct of arrays）：每个字段一个连续的 QVector，没有逐条的堆对象
+ * - 删除时用最后一行填补空位，所有操作 O(1)，行号因此不稳定，对外一律用笔记ID
+ * - 时间戳存为自纪元起的毫秒数，排序和比较只是整数运算
+ * - 笔记ID和分类ID存为 16 字节的 NoteId，ID → 行号用开放寻址哈希表
+ * - 分类ID驻留（interning）：每个分类ID只存一份，每行只存 4 字节的分类句柄
+ * - 分类 → 行号的二级索引随插入、删除和改分类增量维护，按分类取笔记不必扫描全表
+ * - mutable 列缓存纯文本和预览，只在正文修改时失效
+ */
+
+#ifndef NOTETABLE_H
+#define NOTETABLE_H
+
+#include <QDateTime>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "NoteId.h"
+#include "NoteRecord.h"
+
+/**
+ * @class NoteTable
+ * @brief 全部笔记的紧凑存储（由 NoteManager 持有，仅在 GUI 线程使用）
+ *
+ * 只负责存取，不发信号、不更新修改时间；
+ * 这些由 NoteManager 的修改方法统一处理
+ */
+class NoteTable
+{
+public:
+    NoteTable();
+
+    // 行管理
+    int size() const;
+    bool isEmpty() const;
+    int rowOf(const QString &id) const;
+    int rowOf(const NoteId &id) const;
+    bool contains(const QString &id) const;
+    QStringList ids() const;
+    void reserve(int size);
+    void clear();
+    int insert(const NoteRecord &record);
+    void remove(int row);
+
+    // 记录转换
+    NoteRecord record(int row) const;
+
+    // 读取
+    QString id(int row) const;
+    NoteId key(int row) const;
+    QString title(int row) const;
+    QString content(int row) const;
+    QString categoryId(int row) const;
+    int categoryHandle(int row) const;
+    QDateTime createdAt(int row) const;
+    QDateTime updatedAt(int row) const;
+    qint64 updatedMSecs(int row) const;
+    bool isPinned(int row) const;
+    bool isContentLoaded(int row) const;
+    qint64 contentSize(int row) const;
+    QString plainText(int row) const;
+    QString cachedPlainText(int row) const;
+    void cachePlainText(int row, const QString &plainText) const;
+    QString preview(int row, int maxLength = NoteRecord::PreviewLength) const;
+
+    // 修改
+    void setTitle(int row, const QString &title);
+    void setContent(int row, const QString &content);
+    void setCategoryId(int row, const QString &categoryId);
+    void setPinned(int row, bool pinned);
+    void setUpdatedAt(int row, const QDateTime &updatedAt);
+    void rebindContent(int row, const NoteContentRef &ref);
+
+    // 分类句柄：0 表示未分类，-1 表示表中从未出现过的分类
+    int findCategoryHandle(const QString &categoryId) const;
+    QVector<int> rowsInCategory(int handle) const;
+    int countInCategory(int handle) const;
+
+private:
+    static qint64 toMSecs(const QDateTime &dateTime);
+    static QDateTime fromMSecs(qint64 msecs);
+    quint32 internCategory(const QString &categoryId);
+    void linkCategory(int row);
+    void unlinkCategory(int row);
+
+    NoteIdHash<int> m_rows;                 // 笔记ID → 行号
+    QVector<NoteId> m_ids;
+    QVector<QString> m_titles;
+    QVector<QString> m_contents;            // 按需加载时为空
+    QVector<NoteContentRef> m_contentRefs;  // 有效时正文尚在磁盘上
+    QVector<quint32> m_categoryHandles;     // 分类句柄，未分类为 0
+    QVector<int> m_categoryPositions;       // 在所属分类行号列表中的位置
+    QVector<qint64> m_createdAt;            // 毫秒，无效时间为 kInvalidTime
+    QVector<qint64> m_updatedAt;
+    QVector<bool> m_pinned;
+    mutable QVector<QString> m_plainTexts;  // 正文纯文本的缓存，正文修改时清空
+    mutable QVector<QString> m_previews;    // 默认长度预览的缓存，正文修改时清空
+
+    // 驻留的分类ID：句柄 → 分类ID（句柄 0 是空ID），分类ID → 句柄
+    QVector<NoteId> m_categoryIds;
+    NoteIdHash<quint32> m_categoryIndex;
+    QVector<QVector<int>> m_categoryRows;   // 句柄 → 该分类的行号（无序）
+};
+
+#endif // NOTETABLE_H
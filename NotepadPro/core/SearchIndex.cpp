@@ -0,0 +1,1176 @@
+/**
+ * @file SearchIndex.cpp
+ * @brief 笔记全文倒排索引实现
+ *
+ * 知识点：
+ * - std::lower_bound() 在有序列表中二分查找
+ * - std::set_intersection() 和双指针合并，线性时间处理两个有序列表
+ * - BM25：idf 衡量词的稀有程度，tf/(k1+tf) 让词频的贡献逐渐饱和
+ * - QDataStream 直接读写 QFile，读入时逐个构造字符串和列表（调用方在工作线程中读入）
+ * - 验证匹配使用与笔记表共享的纯文本，不在每次查询时把 HTML 重新转成纯文本
+ */
+
+#include "SearchIndex.h"
+#include "Tokenizer.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <utility>
+
+namespace {
+// BM25 参数：k1 控制词频饱和速度，b 控制长度归一化强度
+const double kK1 = 1.2;
+const double kB = 0.75;
+// 字段权重：标题中出现的词比正文更重要
+const double kTitleWeight = 3.0;
+const double kBodyWeight = 1.0;
+// 只按子串（或正则）命中时的基础分，命中位置在标题中时再乘以标题权重
+const double kSubstringScore = 0.5;
+// 分批查询时每批检查的候选数
+const int kBatchSize = 256;
+// 默认每次查询最多为多少条没有纯文本的笔记读取正文（通常由调用方设为要显示的条数）
+const int kDefaultBodyReadLimit = 200;
+// 索引文件头（"NPSI"）和格式版本，格式变化时递增版本号，旧文件会被忽略并重建
+const quint32 kFileMagic = 0x4e505349;
+const quint32 kFileVersion = 5;
+// 读入的索引中文档编号的范围超过文档数的这个倍数时重新编号
+const quint32 kSparseDocIdFactor = 2;
+
+/**
+ * @brief 从有序列表中删除一个文档编号
+ */
+void erasePosting(QVector<quint32> *list, quint32 docId)
+{
+    auto pos = std::lower_bound(list->begin(), list->end(), docId);
+    if (pos != list->end() && *pos == docId) {
+        list->erase(pos);
+    }
+}
+
+/**
+ * @brief 从 key 对应的列表中删除一个文档编号，列表变空时连同 key 一起删除
+ */
+template <typename Map, typename Key>
+void erasePosting(Map *map, const Key &key, quint32 docId)
+{
+    auto it = map->find(key);
+    if (it == map->end()) {
+        return;
+    }
+    erasePosting(&it.value(), docId);
+    if (it.value().isEmpty()) {
+        map->erase(it);
+    }
+}
+}
+
+/**
+ * @brief 构造函数
+ */
+SearchIndex::SearchIndex()
+    : m_nextDocId(0)
+    , m_totalTitleLength(0)
+    , m_totalBodyLength(0)
+    , m_bodyReadLimit(kDefaultBodyReadLimit)
+    , m_generation(0)
+    , m_lastGeneration(0)
+    , m_lastComplete(false)
+{
+}
+
+/**
+ * @brief 索引（或重新索引）一条笔记
+ * @param record 笔记记录（只记下标题和正文的引用，正文不复制）
+ * @param plainText 正文纯文本（分词，并共享给子串验证，不复制）
+ * @param metadata 分类、置顶、修改时间（结构化查询按它们过滤）
+ * @param fingerprint 笔记元数据的指纹（由调用方计算，保存后用来判断索引是否过期）
+ * @param contentHash 正文的散列（指纹不足以判断时比较）
+ */
+void SearchIndex::addNote(const NoteRecord &record, const QString &plainText,
+                          const Metadata &metadata, quint64 fingerprint, quint64 contentHash)
+{
+    const QString &noteId = record.id;
+    const QString &title = record.title;
+    removeNote(noteId);
+
+    Document document;
+    document.noteId = noteId;
+    document.fingerprint = fingerprint;
+    document.contentHash = contentHash;
+    document.categoryId = metadata.categoryId;
+    document.pinned = metadata.pinned;
+    document.updatedSecs = metadata.updatedAt.isValid() ? metadata.updatedAt.toSecsSinceEpoch() : 0;
+    document.titleTerms = Tokenizer::tokenize(title);
+    const QStringList bodyTerms = Tokenizer::tokenize(plainText);
+    document.bodyLength = bodyTerms.size();
+    for (const QString &term : std::as_const(document.titleTerms)) {
+        TermStats &stats = document.terms[term];
+        stats.title = quint16(qMin(stats.title + 1, 0xffff));
+    }
+    for (const QString &term : bodyTerms) {
+        TermStats &stats = document.terms[term];
+        stats.body = quint16(qMin(stats.body + 1, 0xffff));
+    }
+
+    document.title = title;
+    document.plainText = plainText;
+    document.content = record.content;
+    document.contentRef = record.contentRef;
+
+    const quint32 docId = m_nextDocId++;
+    for (auto it = document.terms.constBegin(); it != document.terms.constEnd(); ++it) {
+        m_postings[it.key()].append(docId);
+    }
+    // 标题和正文之间用换行分开，子串不会跨越两者
+    m_trigrams.addDocument(docId, title + QLatin1Char('\n') + plainText);
+    m_fuzzyTitles.addDocument(docId, title);
+    m_categoryPostings[document.categoryId].append(docId);
+    if (document.pinned) {
+        m_pinnedDocs.append(docId);
+    }
+    m_updatedPostings[document.updatedSecs].append(docId);
+    m_totalTitleLength += document.titleTerms.size();
+    m_totalBodyLength += document.bodyLength;
+    m_docIds.insert(noteId, docId);
+    m_documents.insert(docId, document);
+    ++m_generation;
+}
+
+/**
+ * @brief 从索引中移除一条笔记
+ * @param noteId 笔记ID
+ */
+void SearchIndex::removeNote(const QString &noteId)
+{
+    const auto idIt = m_docIds.constFind(noteId);
+    if (idIt == m_docIds.constEnd()) {
+        return;
+    }
+    const quint32 docId = idIt.value();
+    m_docIds.erase(idIt);
+
+    const Document document = m_documents.take(docId);
+    for (auto termIt = document.terms.constBegin(); termIt != document.terms.constEnd(); ++termIt) {
+        erasePosting(&m_postings, termIt.key(), docId);
+    }
+    m_trigrams.removeDocument(docId);
+    m_fuzzyTitles.removeDocument(docId);
+    erasePosting(&m_categoryPostings, document.categoryId, docId);
+    if (document.pinned) {
+        erasePosting(&m_pinnedDocs, docId);
+    }
+    erasePosting(&m_updatedPostings, document.updatedSecs, docId);
+    m_totalTitleLength -= document.titleTerms.size();
+    m_totalBodyLength -= document.bodyLength;
+    ++m_generation;
+}
+
+/**
+ * @brief 重新指定验证匹配时读取正文的位置
+ * @param noteId 笔记ID
+ * @param content 常驻内存的正文
+ * @param contentRef 按需加载时正文在数据源中的位置
+ *
+ * 用于 load() 之后（文件中不保存正文的位置）和数据文件重写之后（数据源换成了新文件），
+ * 索引内容不变，不改变版本号
+ */
+void SearchIndex::setContent(const QString &noteId, const QString &content,
+                             const NoteContentRef &contentRef)
+{
+    const auto it = m_docIds.constFind(noteId);
+    if (it == m_docIds.constEnd()) {
+        return;
+    }
+    Document &document = m_documents[it.value()];
+    document.content = content;
+    document.contentRef = contentRef;
+}
+
+/**
+ * @brief 笔记正文的纯文本（索引中已有时）
+ * @return 笔记未索引或纯文本未知（从文件读入）时返回空字符串
+ */
+QString SearchIndex::plainText(const QString &noteId) const
+{
+    const auto it = m_docIds.constFind(noteId);
+    return it == m_docIds.constEnd() ? QString() : m_documents.constFind(it.value())->plainText;
+}
+
+/**
+ * @brief 指定验证匹配时使用的纯文本
+ * @param noteId 笔记ID
+ * @param plainText 由笔记当前正文得到的纯文本（通常是笔记表缓存的那一份）
+ *
+ * 与 setContent() 一样不改变版本号
+ */
+void SearchIndex::setPlainText(const QString &noteId, const QString &plainText)
+{
+    const auto it = m_docIds.constFind(noteId);
+    if (it != m_docIds.constEnd()) {
+        m_documents[it.value()].plainText = plainText;
+        m_lastComplete = false;     // 之前只在标题中查找的笔记现在可以查正文了
+    }
+}
+
+/**
+ * @brief 清空索引
+ */
+void SearchIndex::clear()
+{
+    m_docIds.clear();
+    m_documents.clear();
+    m_postings.clear();
+    m_trigrams.clear();
+    m_fuzzyTitles.clear();
+    m_categoryPostings.clear();
+    m_pinnedDocs.clear();
+    m_updatedPostings.clear();
+    m_indexedAt = QDateTime();
+    m_nextDocId = 0;
+    m_totalTitleLength = 0;
+    m_totalBodyLength = 0;
+    ++m_generation;
+}
+
+/**
+ * @brief 笔记是否已索引
+ */
+bool SearchIndex::contains(const QString &noteId) const
+{
+    return m_docIds.contains(noteId);
+}
+
+/**
+ * @brief 已索引的笔记数
+ */
+int SearchIndex::noteCount() const
+{
+    return m_docIds.size();
+}
+
+/**
+ * @brief 已索引的全部笔记ID
+ */
+QStringList SearchIndex::noteIds() const
+{
+    return m_docIds.keys();
+}
+
+/**
+ * @brief 笔记建索引时的指纹
+ * @param noteId 笔记ID
+ * @return 指纹；笔记未索引时返回 0
+ */
+quint64 SearchIndex::fingerprint(const QString &noteId) const
+{
+    const auto it = m_docIds.constFind(noteId);
+    return it == m_docIds.constEnd() ? 0 : m_documents.constFind(it.value())->fingerprint;
+}
+
+/**
+ * @brief 笔记建索引时正文的散列
+ * @param noteId 笔记ID
+ * @return 散列；笔记未索引时返回 0
+ */
+quint64 SearchIndex::contentHash(const QString &noteId) const
+{
+    const auto it = m_docIds.constFind(noteId);
+    return it == m_docIds.constEnd() ? 0 : m_documents.constFind(it.value())->contentHash;
+}
+
+/**
+ * @brief 把索引保存到文件
+ * @param path 文件路径
+ * @param indexedAt 索引与笔记数据一致的时间（调用方复制索引时的当前时间）
+ * @return 保存成功返回 true
+ *
+ * 保存词表、posting list 和 trigram/标题索引本身，读入后不需要重新分词；
+ * 纯文本与笔记表共享、正文的位置只在本次运行中有效，都不写入文件。
+ * 只读访问，可以在工作线程中对索引的副本调用
+ */
+bool SearchIndex::save(const QString &path, const QDateTime &indexedAt) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << kFileMagic << kFileVersion;
+    out << qint64(indexedAt.isValid() ? indexedAt.toSecsSinceEpoch() : 0);
+    out << m_nextDocId << m_totalTitleLength << m_totalBodyLength;
+
+    out << quint32(m_documents.size());
+    for (auto it = m_documents.constBegin(); it != m_documents.constEnd(); ++it) {
+        const Document &document = it.value();
+        out << it.key() << document.noteId << document.fingerprint << document.contentHash
+            << document.titleTerms
+            << qint32(document.bodyLength) << document.title
+            << document.categoryId << document.pinned << document.updatedSecs;
+        out << quint32(document.terms.size());
+        for (auto termIt = document.terms.constBegin(); termIt != document.terms.constEnd(); ++termIt) {
+            out << termIt.key() << termIt->title << termIt->body;
+        }
+    }
+    out << m_postings;
+    m_trigrams.write(out);
+    m_fuzzyTitles.write(out);
+    out << m_categoryPostings << m_pinnedDocs << m_updatedPostings;
+
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+/**
+ * @brief 从文件读入 save() 保存的索引
+ * @param path 文件路径
+ * @return 读入成功返回 true；文件不存在、版本不符或已损坏时返回 false，索引保持不变
+ *
+ * 读入的笔记还没有正文，调用方需要用 setContent() 逐条指定后再查询。
+ * 耗时与文件大小成正比，应在工作线程中调用
+ */
+bool SearchIndex::load(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != kFileMagic || version != kFileVersion) {
+        return false;
+    }
+
+    SearchIndex index;
+    qint64 indexedSecs = 0;
+    in >> indexedSecs;
+    if (indexedSecs > 0) {
+        index.m_indexedAt = QDateTime::fromSecsSinceEpoch(indexedSecs);
+    }
+    in >> index.m_nextDocId >> index.m_totalTitleLength >> index.m_totalBodyLength;
+
+    quint32 documentCount = 0;
+    in >> documentCount;
+    for (quint32 i = 0; i < documentCount && in.status() == QDataStream::Ok; ++i) {
+        quint32 docId = 0;
+        Document document;
+        qint32 bodyLength = 0;
+        quint32 termCount = 0;
+        in >> docId >> document.noteId >> document.fingerprint >> document.contentHash
+           >> document.titleTerms
+           >> bodyLength >> document.title
+           >> document.categoryId >> document.pinned >> document.updatedSecs >> termCount;
+        document.bodyLength = bodyLength;
+        for (quint32 j = 0; j < termCount && in.status() == QDataStream::Ok; ++j) {
+            QString term;
+            TermStats stats;
+            in >> term >> stats.title >> stats.body;
+            document.terms.insert(term, stats);
+        }
+        index.m_docIds.insert(document.noteId, docId);
+        index.m_documents.insert(docId, document);
+    }
+    in >> index.m_postings;
+    index.m_trigrams.read(in);
+    index.m_fuzzyTitles.read(in);
+    in >> index.m_categoryPostings >> index.m_pinnedDocs >> index.m_updatedPostings;
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    // 笔记每次修改都换新编号，索引长期保存在文件中时编号越来越稀疏，读入时重新编号
+    if (index.m_nextDocId > kSparseDocIdFactor * quint32(index.m_documents.size())) {
+        index.renumberDocuments();
+    }
+
+    // 反序列化出的每个分类ID都是单独的字符串，改为共享元数据列表中的那一份
+    for (Document &document : index.m_documents) {
+        const auto it = index.m_categoryPostings.constFind(document.categoryId);
+        if (it != index.m_categoryPostings.constEnd()) {
+            document.categoryId = it.key();
+        }
+    }
+
+    index.m_generation = m_generation + 1;
+    *this = index;
+    return true;
+}
+
+/**
+ * @brief 设置每次查询最多为多少条没有纯文本的笔记读取正文
+ * @param limit 条数，通常是要显示的结果数
+ *
+ * 纯文本已共享的笔记不受影响；超出的笔记只在标题中验证短语和正则，
+ * 查询耗时因此不会随这类笔记的数量和正文长度增长。普通关键词查询不使用这个上限，从不读取正文
+ */
+void SearchIndex::setBodyReadLimit(int limit)
+{
+    m_bodyReadLimit = qMax(0, limit);
+}
+
+/**
+ * @brief 读入的索引文件对应的时间
+ * @return 没有从文件读入时无效
+ *
+ * 修改时间早于它、指纹又相同的笔记自保存以来没有变化，不必读取正文比较散列
+ */
+QDateTime SearchIndex::indexedAt() const
+{
+    return m_indexedAt;
+}
+
+/**
+ * @brief 查询
+ * @param query 查询文本
+ * @return 命中的笔记及相关度（按文档编号排列，未排序）
+ */
+QVector<SearchIndex::Hit> SearchIndex::search(const QString &query) const
+{
+    QVector<Hit> hits;
+    search(query, [&hits](const QVector<Hit> &batch) {
+        hits += batch;
+        return true;
+    });
+    return hits;
+}
+
+/**
+ * @brief 分批查询
+ * @param query 查询文本
+ * @param onBatch 每检查完一批候选调用一次（批次可能为空），返回 false 取消查询
+ * @return 查询完成返回 true，被取消返回 false
+ *
+ * 两种匹配取并集：
+ * - 按词匹配：查询分词后每个词都出现即命中（单词按前缀，中文按单字/bigram）；
+ *   中文查询“笔记本”拆成 笔记、记本 两个 bigram，不依赖词典
+ * - 按子串匹配：查询原文作为子串出现在标题或正文纯文本中即命中（不区分大小写），
+ *   不足 3 个字符且能分出词时只按词匹配，避免全量扫描；
+ *   没有共享纯文本的笔记（从索引文件读入、本次运行尚未重新索引）只在标题中查找，
+ *   边输入边搜索时不会为了验证候选而读取、转换正文
+ *
+ * 按词命中的笔记用 BM25F 计分，子串命中再加一个基础分。
+ * 查询是上一次查询的延伸时，只在上一次的命中中筛选：上一次只按词命中的笔记不再查找子串，
+ * 其余的从上一次子串首次出现的位置开始查找，不必从头扫描正文。
+ * 耗时主要在逐条验证候选上，这一步按批进行，调用方可以边查边显示结果
+ */
+bool SearchIndex::search(const QString &query, const BatchCallback &onBatch) const
+{
+    if (query.isEmpty()) {
+        return onBatch(QVector<Hit>());
+    }
+
+    const QVector<QueryTerm> terms = parseQuery(query);
+    const bool withSubstring = terms.isEmpty() || query.size() >= 3;
+    const bool refine = canRefine(query);
+
+    // 候选：走索引时按词的候选已经过验证；子串候选总是需要逐条验证
+    PostingList termCandidates;
+    PostingList substringCandidates;
+    if (refine) {
+        if (!terms.isEmpty()) {
+            termCandidates = m_lastMatches;
+        }
+        if (withSubstring) {
+            substringCandidates = m_lastMatches;
+        }
+    } else {
+        if (!terms.isEmpty()) {
+            termCandidates = matchAll(terms);
+        }
+        if (withSubstring && !m_trigrams.candidates(query, &substringCandidates)) {
+            substringCandidates = allDocuments();
+        }
+    }
+
+    // 双指针合并两个有序列表，同时知道每个候选来自哪一边
+    int bodyReads = 0;
+    QVector<Hit> batch;
+    PostingList matches;
+    QVector<int> positions;
+    int i = 0;
+    int j = 0;
+    int checked = 0;
+    while (i < termCandidates.size() || j < substringCandidates.size()) {
+        const bool fromTerms = i < termCandidates.size()
+                && (j >= substringCandidates.size()
+                    || termCandidates.at(i) <= substringCandidates.at(j));
+        const bool fromSubstring = j < substringCandidates.size()
+                && (i >= termCandidates.size()
+                    || substringCandidates.at(j) <= termCandidates.at(i));
+        const quint32 docId = fromTerms ? termCandidates.at(i) : substringCandidates.at(j);
+        const Document &document = *m_documents.constFind(docId);
+
+        const bool termHit = fromTerms
+                && (!refine || std::all_of(terms.constBegin(), terms.constEnd(),
+                                           [this, &document](const QueryTerm &term) {
+                                               return termMatches(document, term);
+                                           }));
+        int position = -1;
+        if (fromSubstring) {
+            const int from = refine ? m_lastPositions.at(j) : 0;
+            position = from >= 0 ? indexOf(document, query, &bodyReads, from) : -1;
+        }
+
+        if (termHit || position >= 0) {
+            double score = 0.0;
+            if (termHit) {
+                for (const QueryTerm &term : terms) {
+                    score += termScore(document, term);
+                }
+            }
+            if (position >= 0) {
+                score += fieldBonus(document, position);
+            }
+            batch.append(Hit{document.noteId, score});
+            matches.append(docId);
+            positions.append(position);
+        }
+
+        i += fromTerms ? 1 : 0;
+        j += fromSubstring ? 1 : 0;
+        if (++checked % kBatchSize == 0) {
+            if (!onBatch(batch)) {
+                return false;
+            }
+            batch.clear();
+        }
+    }
+    if (!onBatch(batch)) {
+        return false;
+    }
+
+    m_lastQuery = query;
+    m_lastMatches = matches;
+    m_lastPositions = positions;
+    m_lastGeneration = m_generation;
+    m_lastComplete = withSubstring;
+    return true;
+}
+
+/**
+ * @brief 正则表达式查询
+ * @param pattern 正则表达式（无效时返回空列表）
+ * @return 标题或正文能匹配的笔记；首个匹配在标题中的分数更高
+ */
+QVector<SearchIndex::Hit> SearchIndex::searchRegex(const QRegularExpression &pattern) const
+{
+    QVector<Hit> hits;
+    searchRegex(pattern, [&hits](const QVector<Hit> &batch) {
+        hits += batch;
+        return true;
+    });
+    return hits;
+}
+
+/**
+ * @brief 分批进行正则表达式查询
+ * @param pattern 正则表达式
+ * @param onBatch 每检查完一批候选调用一次，返回 false 取消查询
+ * @return 查询完成返回 true，被取消返回 false
+ *
+ * 从表达式中提取必定出现的字面量片段，用它们的 trigram 缩小候选范围，
+ * 再对候选笔记执行真正的正则匹配
+ */
+bool SearchIndex::searchRegex(const QRegularExpression &pattern,
+                              const BatchCallback &onBatch) const
+{
+    if (!pattern.isValid()) {
+        return onBatch(QVector<Hit>());
+    }
+
+    PostingList candidates = allDocuments();
+    const QStringList literals = TrigramIndex::requiredLiterals(pattern.pattern());
+    for (const QString &literal : literals) {
+        PostingList list;
+        if (m_trigrams.candidates(literal, &list)) {
+            candidates = intersect(candidates, list);
+        }
+    }
+
+    int bodyReads = m_bodyReadLimit;
+    QVector<Hit> batch;
+    for (int i = 0; i < candidates.size(); ++i) {
+        const Document &document = *m_documents.constFind(candidates.at(i));
+        const QRegularExpressionMatch match = pattern.match(documentText(document, &bodyReads));
+        if (match.hasMatch()) {
+            batch.append(Hit{document.noteId, fieldBonus(document, match.capturedStart())});
+        }
+        if ((i + 1) % kBatchSize == 0) {
+            if (!onBatch(batch)) {
+                return false;
+            }
+            batch.clear();
+        }
+    }
+    return onBatch(batch);
+}
+
+/**
+ * @brief 标题模糊查询
+ * @param query 查询文本
+ * @return 标题近似匹配的笔记，分数为匹配质量（未排序）
+ */
+QVector<SearchIndex::Hit> SearchIndex::searchFuzzyTitle(const QString &query) const
+{
+    QVector<Hit> hits;
+    searchFuzzyTitle(query, [&hits](const QVector<Hit> &batch) {
+        hits += batch;
+        return true;
+    });
+    return hits;
+}
+
+/**
+ * @brief 分批进行标题模糊查询
+ * @param query 查询文本，空格分隔的词顺序不限，每个词允许少量拼写错误
+ * @param onBatch 每检查完一批候选调用一次，返回 false 取消查询
+ * @return 查询完成返回 true，被取消返回 false
+ */
+bool SearchIndex::searchFuzzyTitle(const QString &query, const BatchCallback &onBatch) const
+{
+    return m_fuzzyTitles.match(query, [this, &onBatch](const QVector<FuzzyTitleIndex::Match> &matches) {
+        QVector<Hit> batch;
+        batch.reserve(matches.size());
+        for (const FuzzyTitleIndex::Match &match : matches) {
+            batch.append(Hit{m_documents.constFind(match.docId)->noteId, match.score});
+        }
+        return onBatch(batch);
+    });
+}
+
+/**
+ * @brief 结构化查询
+ * @param query 解析后的查询（分类名称已由调用方换成分类ID）
+ * @return 满足全部条件的笔记（未排序）
+ */
+QVector<SearchIndex::Hit> SearchIndex::searchQuery(const SearchQuery &query) const
+{
+    QVector<Hit> hits;
+    searchQuery(query, [&hits](const QVector<Hit> &batch) {
+        hits += batch;
+        return true;
+    });
+    return hits;
+}
+
+/**
+ * @brief 分批进行结构化查询
+ * @param query 解析后的查询
+ * @param onBatch 每检查完一批候选调用一次，返回 false 取消查询
+ * @return 查询完成返回 true，被取消返回 false
+ *
+ * 查询计划：
+ * 1. 每个能用索引回答的条件（关键词、短语的 trigram、分类、置顶、修改时间）对应一个有序列表，
+ *    按估计长度从短到长求交集，结果为空时后面的列表不再生成
+ * 2. 排除条件（-词、-category:、-updated:、pinned:false）从候选中减去
+ * 3. 只剩下标题限定、排除的标题词、短语和排除短语需要在候选上逐条验证
+ *
+ * 关键词按 BM25F 计分，短语加基础分；只有过滤条件时每条命中的分数相同，
+ * 排序交给调用方的新近度和置顶加成
+ */
+bool SearchIndex::searchQuery(const SearchQuery &query, const BatchCallback &onBatch) const
+{
+    const QVector<QueryTerm> words = parseQuery(query.words.join(QLatin1Char(' ')));
+    const QVector<QueryTerm> titleWords = parseQuery(query.titleWords.join(QLatin1Char(' ')));
+    QVector<QueryTerm> excludedTitleWords = parseQuery(query.excludedTitleWords.join(QLatin1Char(' ')));
+    for (QueryTerm &term : excludedTitleWords) {
+        term.prefix = false;
+    }
+
+    // 条件：估计长度 + 生成列表的方法（前缀合并等较贵的列表推迟到真正需要时再生成）
+    struct Condition
+    {
+        int estimate;
+        std::function<PostingList()> postings;
+    };
+    QVector<Condition> conditions;
+
+    for (const QVector<QueryTerm> *terms : {&words, &titleWords}) {
+        for (const QueryTerm &term : *terms) {
+            conditions.append(Condition{term.documentFrequency,
+                                        [this, term]() { return termPostings(term); }});
+        }
+    }
+    for (const QString &phrase : query.phrases) {
+        PostingList list;
+        if (m_trigrams.candidates(phrase, &list)) {
+            conditions.append(Condition{list.size(), [list]() { return list; }});
+        }
+    }
+    if (!query.category.isEmpty()) {
+        PostingList list;
+        for (const QString &categoryId : query.categoryIds) {
+            list = unite(list, m_categoryPostings.value(categoryId));
+        }
+        conditions.append(Condition{list.size(), [list]() { return list; }});
+    }
+    if (query.pinned == SearchQuery::OnlyPinned) {
+        conditions.append(Condition{m_pinnedDocs.size(), [this]() { return m_pinnedDocs; }});
+    }
+    if (query.updatedFrom.isValid() || query.updatedTo.isValid()) {
+        const PostingList list = updatedBetween(query.updatedFrom, query.updatedTo);
+        conditions.append(Condition{list.size(), [list]() { return list; }});
+    }
+
+    PostingList candidates;
+    if (conditions.isEmpty()) {
+        candidates = allDocuments();
+    } else {
+        std::sort(conditions.begin(), conditions.end(), [](const Condition &a, const Condition &b) {
+            return a.estimate < b.estimate;
+        });
+        candidates = conditions.first().postings();
+        for (int i = 1; i < conditions.size() && !candidates.isEmpty(); ++i) {
+            candidates = intersect(candidates, conditions.at(i).postings());
+        }
+    }
+
+    // 排除条件：整词匹配（-proj 不排除 project）
+    if (query.pinned == SearchQuery::OnlyUnpinned) {
+        candidates = subtract(candidates, m_pinnedDocs);
+    }
+    for (const QString &word : query.excludedWords) {
+        QVector<QueryTerm> terms = parseQuery(word);
+        if (terms.isEmpty() || candidates.isEmpty()) {
+            continue;
+        }
+        for (QueryTerm &term : terms) {
+            term.prefix = false;
+        }
+        candidates = subtract(candidates, matchAll(terms));
+    }
+    if (!query.excludedCategoryIds.isEmpty()) {
+        PostingList list;
+        for (const QString &categoryId : query.excludedCategoryIds) {
+            list = unite(list, m_categoryPostings.value(categoryId));
+        }
+        candidates = subtract(candidates, list);
+    }
+    for (const QPair<QDateTime, QDateTime> &range : query.excludedUpdated) {
+        if (candidates.isEmpty()) {
+            break;
+        }
+        candidates = subtract(candidates, updatedBetween(range.first, range.second));
+    }
+
+    int bodyReads = m_bodyReadLimit;
+    QVector<Hit> batch;
+    for (int i = 0; i < candidates.size(); ++i) {
+        const Document &document = *m_documents.constFind(candidates.at(i));
+
+        bool accepted = std::all_of(titleWords.constBegin(), titleWords.constEnd(),
+                                    [this, &document](const QueryTerm &term) {
+                                        return titleMatches(document, term);
+                                    })
+                && std::none_of(excludedTitleWords.constBegin(), excludedTitleWords.constEnd(),
+                                [this, &document](const QueryTerm &term) {
+                                    return titleMatches(document, term);
+                                });
+        for (const QString &phrase : query.excludedPhrases) {
+            if (!accepted) {
+                break;
+            }
+            accepted = indexOf(document, phrase, &bodyReads) < 0;
+        }
+
+        double score = 0.0;
+        for (const QString &phrase : query.phrases) {
+            if (!accepted) {
+                break;
+            }
+            const int position = indexOf(document, phrase, &bodyReads);
+            accepted = position >= 0;
+            score += accepted ? fieldBonus(document, position) : 0.0;
+        }
+
+        if (accepted) {
+            for (const QVector<QueryTerm> *terms : {&words, &titleWords}) {
+                for (const QueryTerm &term : *terms) {
+                    score += termScore(document, term);
+                }
+            }
+            batch.append(Hit{document.noteId, score > 0.0 ? score : 1.0});
+        }
+
+        if ((i + 1) % kBatchSize == 0) {
+            if (!onBatch(batch)) {
+                return false;
+            }
+            batch.clear();
+        }
+    }
+    return onBatch(batch);
+}
+
+/**
+ * @brief 把文档编号重新编为 0 ~ 文档数-1
+ *
+ * 新旧编号的先后顺序相同，所有列表逐个映射后仍然有序，不需要重新排序
+ */
+void SearchIndex::renumberDocuments()
+{
+    const PostingList oldIds = allDocuments();
+    QHash<quint32, quint32> newIds;
+    newIds.reserve(oldIds.size());
+    for (int i = 0; i < oldIds.size(); ++i) {
+        newIds.insert(oldIds.at(i), quint32(i));
+    }
+    auto renumber = [&newIds](PostingList &list) {
+        for (quint32 &docId : list) {
+            docId = newIds.value(docId);
+        }
+    };
+
+    for (PostingList &list : m_postings) {
+        renumber(list);
+    }
+    for (PostingList &list : m_categoryPostings) {
+        renumber(list);
+    }
+    renumber(m_pinnedDocs);
+    for (PostingList &list : m_updatedPostings) {
+        renumber(list);
+    }
+    m_trigrams.renumber(newIds);
+    m_fuzzyTitles.renumber(newIds);
+
+    QHash<quint32, Document> documents;
+    documents.reserve(m_documents.size());
+    for (auto it = m_documents.constBegin(); it != m_documents.constEnd(); ++it) {
+        const quint32 docId = newIds.value(it.key());
+        documents.insert(docId, it.value());
+        m_docIds.insert(it->noteId, docId);
+    }
+    m_documents = documents;
+    m_nextDocId = quint32(oldIds.size());
+    m_lastMatches.clear();
+    m_lastPositions.clear();
+    m_lastComplete = false;
+    ++m_generation;
+}
+
+/**
+ * @brief 索引版本号，每次增删笔记都会变化
+ */
+quint64 SearchIndex::generation() const
+{
+    return m_generation;
+}
+
+/**
+ * @brief 能否在上一次查询的命中中筛选
+ *
+ * 条件：索引没有变化；新查询以上一次查询开头；
+ * 上一次同时做了词匹配和子串匹配（否则它的命中不一定覆盖新查询的子串命中）。
+ * 在查询中间修改、删除字符时回到索引查询
+ */
+bool SearchIndex::canRefine(const QString &query) const
+{
+    return m_lastComplete
+            && m_lastGeneration == m_generation
+            && !m_lastQuery.isEmpty()
+            && query.startsWith(m_lastQuery);
+}
+
+/**
+ * @brief 笔记是否包含某个查询词
+ */
+bool SearchIndex::termMatches(const Document &document, const QueryTerm &term) const
+{
+    if (document.terms.contains(term.term)) {
+        return true;
+    }
+    if (!term.prefix) {
+        return false;
+    }
+    for (auto it = document.terms.constBegin(); it != document.terms.constEnd(); ++it) {
+        if (it.key().startsWith(term.term)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 笔记标题是否包含某个查询词
+ */
+bool SearchIndex::titleMatches(const Document &document, const QueryTerm &term) const
+{
+    for (const QString &titleTerm : document.titleTerms) {
+        if (term.prefix ? titleTerm.startsWith(term.term) : titleTerm == term.term) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 查询分词并统计每个词的文档频率
+ *
+ * 单词按前缀匹配（边输入边搜索）；CJK 单字和 bigram 本身就是完整的词，按整词匹配。
+ * 前缀的文档频率取各匹配词列表长度之和，不需要真正合并列表，
+ * 因此从索引查询和从上一次结果筛选得到的分数相同
+ */
+QVector<SearchIndex::QueryTerm> SearchIndex::parseQuery(const QString &query) const
+{
+    QStringList words = Tokenizer::tokenize(query, Tokenizer::QueryMode);
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    QVector<QueryTerm> terms;
+    for (const QString &word : std::as_const(words)) {
+        const bool prefix = !Tokenizer::isCjkToken(word);
+        int frequency = 0;
+        if (prefix) {
+            for (auto it = m_postings.lowerBound(word);
+                 it != m_postings.constEnd() && it.key().startsWith(word); ++it) {
+                frequency += it.value().size();
+            }
+        } else {
+            frequency = m_postings.value(word).size();
+        }
+        terms.append(QueryTerm{word, prefix, qMin(frequency, m_documents.size())});
+    }
+    return terms;
+}
+
+/**
+ * @brief 查询词匹配的文档（前缀匹配时合并各词的列表）
+ */
+SearchIndex::PostingList SearchIndex::termPostings(const QueryTerm &term) const
+{
+    return term.prefix ? lookupPrefix(term.term) : m_postings.value(term.term);
+}
+
+/**
+ * @brief 包含全部查询词的文档
+ * @return 文档编号（有序）
+ */
+SearchIndex::PostingList SearchIndex::matchAll(const QVector<QueryTerm> &terms) const
+{
+    QVector<PostingList> lists;
+    for (const QueryTerm &term : terms) {
+        if (term.documentFrequency == 0) {
+            return PostingList();
+        }
+        lists.append(termPostings(term));
+    }
+
+    // 从最短的列表开始求交集，中间结果只会越来越小
+    std::sort(lists.begin(), lists.end(), [](const PostingList &a, const PostingList &b) {
+        return a.size() < b.size();
+    });
+    PostingList result = lists.first();
+    for (int i = 1; i < lists.size() && !result.isEmpty(); ++i) {
+        result = intersect(result, lists.at(i));
+    }
+    return result;
+}
+
+/**
+ * @brief 合并以 prefix 开头的所有词的 posting list
+ * @return 有序、无重复的文档编号
+ */
+SearchIndex::PostingList SearchIndex::lookupPrefix(const QString &prefix) const
+{
+    auto it = m_postings.lowerBound(prefix);
+    if (it == m_postings.constEnd() || !it.key().startsWith(prefix)) {
+        return PostingList();
+    }
+
+    // 只有一个词匹配时直接返回（隐式共享，不复制）
+    auto next = std::next(it);
+    if (next == m_postings.constEnd() || !next.key().startsWith(prefix)) {
+        return it.value();
+    }
+
+    PostingList merged;
+    for (; it != m_postings.constEnd() && it.key().startsWith(prefix); ++it) {
+        merged += it.value();
+    }
+    std::sort(merged.begin(), merged.end());
+    merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+    return merged;
+}
+
+/**
+ * @brief 全部文档编号（有序）
+ */
+SearchIndex::PostingList SearchIndex::allDocuments() const
+{
+    PostingList docIds;
+    docIds.reserve(m_documents.size());
+    for (auto it = m_documents.constBegin(); it != m_documents.constEnd(); ++it) {
+        docIds.append(it.key());
+    }
+    std::sort(docIds.begin(), docIds.end());
+    return docIds;
+}
+
+/**
+ * @brief 修改时间在 [from, to) 内的文档编号（有序）
+ * @param from 下限，无效表示不限
+ * @param to 上限（不包含），无效表示不限
+ *
+ * 修改时间按秒排序，lowerBound() 定位区间两端，只遍历区间内的列表
+ */
+SearchIndex::PostingList SearchIndex::updatedBetween(const QDateTime &from, const QDateTime &to) const
+{
+    PostingList docIds;
+    if (from.isValid() && to.isValid() && from >= to) {
+        return docIds;
+    }
+
+    auto it = from.isValid() ? m_updatedPostings.lowerBound(from.toSecsSinceEpoch())
+                             : m_updatedPostings.constBegin();
+    const auto end = to.isValid() ? m_updatedPostings.lowerBound(to.toSecsSinceEpoch())
+                                  : m_updatedPostings.constEnd();
+    for (; it != end; ++it) {
+        docIds += it.value();
+    }
+    std::sort(docIds.begin(), docIds.end());
+    return docIds;
+}
+
+/**
+ * @brief 一个查询词对一条笔记的 BM25F 得分
+ *
+ * 标题和正文的词频先按各自的长度归一化、乘以字段权重再相加，
+ * 然后整体做一次饱和，避免同一个词在两个字段重复计分。
+ * 前缀匹配而笔记中没有完全相同的词时，标题词频按前缀统计，正文按出现一次计
+ */
+double SearchIndex::termScore(const Document &document, const QueryTerm &term) const
+{
+    const double count = m_documents.size();
+    const double df = term.documentFrequency;
+    const double idf = std::log(1.0 + (count - df + 0.5) / (df + 0.5));
+
+    double titleTf = 0.0;
+    double bodyTf = 0.0;
+    const auto it = document.terms.constFind(term.term);
+    if (it != document.terms.constEnd()) {
+        titleTf = it->title;
+        bodyTf = it->body;
+    } else if (term.prefix) {
+        for (const QString &titleTerm : document.titleTerms) {
+            if (titleTerm.startsWith(term.term)) {
+                titleTf += 1.0;
+            }
+        }
+        bodyTf = titleTf > 0.0 ? 0.0 : 1.0;
+    }
+
+    const double avgTitle = qMax(1.0, m_totalTitleLength / count);
+    const double avgBody = qMax(1.0, m_totalBodyLength / count);
+    const double weighted =
+        kTitleWeight * titleTf / (1.0 - kB + kB * document.titleTerms.size() / avgTitle) +
+        kBodyWeight * bodyTf / (1.0 - kB + kB * document.bodyLength / avgBody);
+    return idf * weighted * (kK1 + 1.0) / (weighted + kK1);
+}
+
+/**
+ * @brief 子串/正则命中的基础分
+ * @param matchPosition 首次匹配在 documentText() 中的位置
+ */
+double SearchIndex::fieldBonus(const Document &document, int matchPosition) const
+{
+    return matchPosition >= 0 && matchPosition < document.title.size()
+            ? kSubstringScore * kTitleWeight : kSubstringScore;
+}
+
+/**
+ * @brief 笔记正文的纯文本
+ * @param bodyReads 本次查询还允许读取正文的次数，读取一次减一
+ * @return 纯文本；没有共享的纯文本且次数已用完时返回空字符串
+ *
+ * 优先使用共享的纯文本；没有时才读取正文并转换（结果不缓存）。
+ * 只读访问，可以在工作线程中调用
+ */
+QString SearchIndex::bodyText(const Document &document, int *bodyReads)
+{
+    if (!document.plainText.isNull()) {
+        return document.plainText;
+    }
+    if (*bodyReads <= 0) {
+        return QString();
+    }
+    --*bodyReads;
+    return NoteRecord::plainTextFromHtml(document.contentRef.isValid()
+                                         ? document.contentRef.load() : document.content);
+}
+
+/**
+ * @brief 标题 + 换行 + 正文纯文本，即建 trigram 索引时使用的文本
+ */
+QString SearchIndex::documentText(const Document &document, int *bodyReads)
+{
+    return document.title + QLatin1Char('\n') + bodyText(document, bodyReads);
+}
+
+/**
+ * @brief 不区分大小写地查找子串
+ * @param from 从 documentText() 中的这个位置开始查找
+ * @return 在 documentText() 中的位置，找不到返回 -1
+ *
+ * 先查标题，标题中找到时不必看正文
+ */
+int SearchIndex::indexOf(const Document &document, const QString &text, int *bodyReads, int from)
+{
+    const int titleSize = document.title.size();
+    if (from < titleSize) {
+        const int titlePosition = document.title.indexOf(text, from, Qt::CaseInsensitive);
+        if (titlePosition >= 0) {
+            return titlePosition;
+        }
+    }
+    const int bodyFrom = qMax(0, from - titleSize - 1);
+    const int bodyPosition = bodyText(document, bodyReads)
+            .indexOf(text, bodyFrom, Qt::CaseInsensitive);
+    return bodyPosition >= 0 ? document.title.size() + 1 + bodyPosition : -1;
+}
+
+/**
+ * @brief 两个有序列表求交集
+ */
+SearchIndex::PostingList SearchIndex::intersect(const PostingList &a, const PostingList &b)
+{
+    PostingList result;
+    result.reserve(qMin(a.size(), b.size()));
+    std::set_intersection(a.constBegin(), a.constEnd(), b.constBegin(), b.constEnd(),
+                          std::back_inserter(result));
+    return result;
+}
+
+/**
+ * @brief 两个有序列表的并集
+ */
+SearchIndex::PostingList SearchIndex::unite(const PostingList &a, const PostingList &b)
+{
+    PostingList result;
+    result.reserve(a.size() + b.size());
+    std::set_union(a.constBegin(), a.constEnd(), b.constBegin(), b.constEnd(),
+                   std::back_inserter(result));
+    return result;
+}
+
+/**
+ * @brief 在 a 中而不在 b 中的文档
+ */
+SearchIndex::PostingList SearchIndex::subtract(const PostingList &a, const PostingList &b)
+{
+    PostingList result;
+    result.reserve(a.size());
+    std::set_difference(a.constBegin(), a.constEnd(), b.constBegin(), b.constEnd(),
+                        std::back_inserter(result));
+    return result;
+}
@@ -0,0 +1,217 @@
+/**
+ * @file SearchIndex.h
+ * @brief 笔记全文倒排索引
+ *
+ * 知识点：
+ * - 倒排索引：词 → 包含该词的文档编号列表（posting list）
+ * - QMap 按键排序，lowerBound() 找出以某个前缀开头的所有词
+ * - 有序列表求交集，从最短的列表开始
+ * - 词索引之外还维护 trigram 索引，支持任意子串和正则表达式
+ * - BM25F 相关度评分：词频饱和、按字段长度归一化，标题权重高于正文
+ * - 标题另建 bigram 索引，支持容错的模糊匹配
+ * - QDataStream 序列化整个索引，下次启动时直接读入，不必重新分词
+ * - 分类、置顶、修改时间也按文档编号建列表，结构化查询的所有条件都是有序列表求交集
+ */
+
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QMap>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+#include "FuzzyTitleIndex.h"
+#include "NoteRecord.h"
+#include "SearchQuery.h"
+#include "TrigramIndex.h"
+
+/**
+ * @class SearchIndex
+ * @brief 标题和正文纯文本的倒排索引
+ *
+ * 每条笔记分配一个递增的文档编号；笔记修改后重新编号，
+ * 因此新文档总是追加在 posting list 末尾，列表始终有序。
+ * 查询时单词按前缀匹配、中文按单字/bigram 整词匹配，所有词都出现的笔记才算命中，
+ * 耗时只与命中词的列表长度有关，与笔记正文长度无关。
+ *
+ * 子串和正则查询先用 trigram 索引找出候选笔记，再逐条用正文纯文本验证，
+ * 结果与逐条扫描相同，但只需要检查一小部分笔记。
+ * 索引不另外保存正文或纯文本的副本：纯文本与笔记表的纯文本缓存共享同一份数据，
+ * 没有纯文本时（从文件读入、本次运行尚未重新索引）才由正文或它在数据源中的位置得到，
+ * 短语和正则查询每次最多这样读取 setBodyReadLimit() 条，其余的只在标题中验证；
+ * 普通关键词查询从不读取正文，这类笔记按词命中或在标题中找到子串才算命中。
+ * 标题模糊查询允许拼写错误和词序颠倒，分数是匹配质量而不是文本相关度。
+ *
+ * 每条命中都带有文本相关度分数，排序和截取前 K 条由调用方完成。
+ *
+ * 边输入边搜索时，新查询只是在上一次查询末尾追加字符（"pro" → "proj"），
+ * 它的结果一定是上一次结果的子集，直接在上一次的结果中逐条筛选，不再查索引；
+ * 新查询的子串只可能出现在上一次子串首次出现的位置或之后，上一次没有子串命中的笔记不必再找。
+ *
+ * 所有成员都是隐式共享的 Qt 容器，复制一份索引的代价很低，
+ * 可以把副本交给工作线程查询，原索引继续在 GUI 线程中更新（写入时才分离）。
+ *
+ * 每条笔记记录调用方给出的元数据指纹和正文散列，文件中还记下索引对应的时间，
+ * 读入后调用方先比较指纹，只有指纹相同、又在这个时间之后修改过的笔记才需要读取正文比较散列；
+ * 正文的位置不写入文件，读入后由调用方用 setContent() 重新指定
+ */
+class SearchIndex
+{
+public:
+    /**
+     * @brief 一条命中
+     */
+    struct Hit
+    {
+        QString noteId;
+        double score;   // 文本相关度，越大越相关
+    };
+
+    /**
+     * @brief 参与过滤的笔记属性
+     */
+    struct Metadata
+    {
+        QString categoryId;
+        bool pinned = false;
+        QDateTime updatedAt;
+    };
+
+    /// 分批回调：返回 false 取消查询
+    using BatchCallback = std::function<bool(const QVector<Hit> &batch)>;
+
+    SearchIndex();
+
+    // 维护
+    void addNote(const NoteRecord &record, const QString &plainText,
+                 const Metadata &metadata = Metadata(), quint64 fingerprint = 0,
+                 quint64 contentHash = 0);
+    void removeNote(const QString &noteId);
+    void setContent(const QString &noteId, const QString &content, const NoteContentRef &contentRef);
+    QString plainText(const QString &noteId) const;
+    void setPlainText(const QString &noteId, const QString &plainText);
+    void clear();
+    bool contains(const QString &noteId) const;
+    int noteCount() const;
+    QStringList noteIds() const;
+    quint64 fingerprint(const QString &noteId) const;
+    quint64 contentHash(const QString &noteId) const;
+    quint64 generation() const;
+
+    // 持久化
+    bool save(const QString &path, const QDateTime &indexedAt) const;
+    bool load(const QString &path);
+    QDateTime indexedAt() const;
+
+    // 查询
+    void setBodyReadLimit(int limit);
+    QVector<Hit> search(const QString &query) const;
+    bool search(const QString &query, const BatchCallback &onBatch) const;
+    QVector<Hit> searchRegex(const QRegularExpression &pattern) const;
+    bool searchRegex(const QRegularExpression &pattern, const BatchCallback &onBatch) const;
+    QVector<Hit> searchFuzzyTitle(const QString &query) const;
+    bool searchFuzzyTitle(const QString &query, const BatchCallback &onBatch) const;
+    QVector<Hit> searchQuery(const SearchQuery &query) const;
+    bool searchQuery(const SearchQuery &query, const BatchCallback &onBatch) const;
+
+private:
+    using PostingList = QVector<quint32>;
+
+    /**
+     * @brief 一个词在某条笔记中的出现次数
+     */
+    struct TermStats
+    {
+        quint16 title = 0;
+        quint16 body = 0;
+    };
+
+    /**
+     * @brief 已索引的笔记
+     */
+    struct Document
+    {
+        QString noteId;
+        quint64 fingerprint = 0;            // 建索引时笔记的元数据指纹
+        quint64 contentHash = 0;            // 建索引时正文的散列
+        QHash<QString, TermStats> terms;    // 词频，删除时也用来定位 posting list
+        QStringList titleTerms;             // 标题中的词（前缀匹配时计算标题词频）
+        int bodyLength = 0;                 // 正文词数
+        QString title;                      // 标题，以下四项用于验证子串/正则匹配
+        QString plainText;                  // 正文纯文本（与笔记表的缓存共享），未知时为空
+        QString content;                    // 常驻内存的正文（与笔记表共享，不另外复制）
+        NoteContentRef contentRef;          // 按需加载时正文在数据源中的位置
+        QString categoryId;                 // 以下属性用于定位元数据列表
+        bool pinned = false;
+        qint64 updatedSecs = 0;
+    };
+
+    /**
+     * @brief 解析后的查询词
+     */
+    struct QueryTerm
+    {
+        QString term;
+        bool prefix;            // 是否按前缀匹配
+        int documentFrequency;  // 包含该词的文档数（前缀匹配时为各词之和的估计）
+    };
+
+    QVector<QueryTerm> parseQuery(const QString &query) const;
+    bool canRefine(const QString &query) const;
+    bool termMatches(const Document &document, const QueryTerm &term) const;
+    bool titleMatches(const Document &document, const QueryTerm &term) const;
+    PostingList termPostings(const QueryTerm &term) const;
+    PostingList matchAll(const QVector<QueryTerm> &terms) const;
+    PostingList lookupPrefix(const QString &prefix) const;
+    PostingList allDocuments() const;
+    PostingList updatedBetween(const QDateTime &from, const QDateTime &to) const;
+    double termScore(const Document &document, const QueryTerm &term) const;
+    double fieldBonus(const Document &document, int matchPosition) const;
+    void renumberDocuments();
+    static QString bodyText(const Document &document, int *bodyReads);
+    static QString documentText(const Document &document, int *bodyReads);
+    static int indexOf(const Document &document, const QString &text, int *bodyReads, int from = 0);
+    static PostingList intersect(const PostingList &a, const PostingList &b);
+    static PostingList unite(const PostingList &a, const PostingList &b);
+    static PostingList subtract(const PostingList &a, const PostingList &b);
+
+    quint32 m_nextDocId;
+    QHash<QString, quint32> m_docIds;
+    QHash<quint32, Document> m_documents;
+    QMap<QString, PostingList> m_postings;
+    TrigramIndex m_trigrams;
+    FuzzyTitleIndex m_fuzzyTitles;
+
+    // 元数据列表：分类ID → 文档，置顶的文档，修改时间（秒）→ 文档
+    QHash<QString, PostingList> m_categoryPostings;
+    PostingList m_pinnedDocs;
+    QMap<qint64, PostingList> m_updatedPostings;
+
+    // 读入的索引文件对应的时间：此前修改的笔记都已按当时的内容索引
+    QDateTime m_indexedAt;
+
+    // 字段总词数，用于计算平均长度
+    qint64 m_totalTitleLength;
+    qint64 m_totalBodyLength;
+
+    // 每次查询最多为多少条没有纯文本的笔记读取正文
+    int m_bodyReadLimit;
+
+    // 索引每次变化都递增，用来判断上一次查询的结果是否仍然有效
+    quint64 m_generation;
+
+    // 上一次查询及其命中（search() 是 const，缓存用 mutable）
+    mutable QString m_lastQuery;
+    mutable PostingList m_lastMatches;
+    mutable QVector<int> m_lastPositions;   // 与 m_lastMatches 对应的子串首次出现位置，-1 表示只按词命中
+    mutable quint64 m_lastGeneration;
+    mutable bool m_lastComplete;    // 上一次是否同时做了词匹配和子串匹配
+};
+
+#endif // SEARCHINDEX_H
@@ -0,0 +1,222 @@
+/**
+ * @file SearchQuery.cpp
+ * @brief 结构化搜索查询实现
+ *
+ * 知识点：
+ * - QDate::fromString(Qt::ISODate) 解析 yyyy-MM-dd
+ * - 日期比较统一换算成半开区间 [from, to)，> 和 <= 都落在“下一天的 0 点”
+ */
+
+#include "SearchQuery.h"
+
+namespace {
+/**
+ * @brief 是否为支持的字段名
+ */
+bool isField(const QString &name)
+{
+    return name == QLatin1String("title") || name == QLatin1String("category")
+            || name == QLatin1String("pinned") || name == QLatin1String("updated");
+}
+
+/**
+ * @brief 某一天的 0 点（本地时间）
+ */
+QDateTime startOfDay(const QDate &date)
+{
+    return QDateTime(date, QTime(0, 0));
+}
+
+/**
+ * @brief 解析置顶过滤值
+ * @param value true/yes/1 或 false/no/0
+ * @param pinned 输出是否置顶
+ * @return 值有效返回 true
+ */
+bool parsePinned(const QString &value, bool *pinned)
+{
+    const QString lower = value.toLower();
+    if (lower == QLatin1String("true") || lower == QLatin1String("yes") || lower == QLatin1String("1")) {
+        *pinned = true;
+        return true;
+    }
+    if (lower == QLatin1String("false") || lower == QLatin1String("no") || lower == QLatin1String("0")) {
+        *pinned = false;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 解析修改日期过滤值
+ * @param value 形如 >2026-01-01、<=2026-01-01 或 2026-01-01
+ * @param from 输出时间下限（包含），不限时无效
+ * @param to 输出时间上限（不包含），不限时无效
+ * @return 值有效返回 true
+ */
+bool parseUpdated(const QString &value, QDateTime *from, QDateTime *to)
+{
+    QString op;
+    for (const char *candidate : {">=", "<=", ">", "<", "="}) {
+        if (value.startsWith(QLatin1String(candidate))) {
+            op = QLatin1String(candidate);
+            break;
+        }
+    }
+    const QDate date = QDate::fromString(value.mid(op.size()), Qt::ISODate);
+    if (!date.isValid()) {
+        return false;
+    }
+
+    if (op == QLatin1String(">")) {
+        *from = startOfDay(date.addDays(1));
+    } else if (op == QLatin1String(">=")) {
+        *from = startOfDay(date);
+    } else if (op == QLatin1String("<")) {
+        *to = startOfDay(date);
+    } else if (op == QLatin1String("<=")) {
+        *to = startOfDay(date.addDays(1));
+    } else {
+        *from = startOfDay(date);
+        *to = startOfDay(date.addDays(1));
+    }
+    return true;
+}
+
+/**
+ * @brief 缩小查询的时间范围，多个日期条件取交集
+ */
+void narrowUpdated(SearchQuery *query, const QDateTime &from, const QDateTime &to)
+{
+    if (from.isValid() && (!query->updatedFrom.isValid() || from > query->updatedFrom)) {
+        query->updatedFrom = from;
+    }
+    if (to.isValid() && (!query->updatedTo.isValid() || to < query->updatedTo)) {
+        query->updatedTo = to;
+    }
+}
+}
+
+/**
+ * @brief 解析查询文本
+ * @param text 用户输入
+ * @return 解析结果（categoryIds、excludedCategoryIds 为空，由调用方按分类名称填入）
+ *
+ * 字段前的 - 表示排除：-pinned:true 等同于 pinned:false，-title:、-category:、-updated:
+ * 排除标题含该词、属于该分类、修改日期在该范围内的笔记；
+ * 值无效的字段（如 pinned:maybe、updated:昨天）整体按普通关键词处理
+ */
+SearchQuery SearchQuery::parse(const QString &text)
+{
+    SearchQuery query;
+    const int size = text.size();
+    int i = 0;
+
+    while (i < size) {
+        if (text.at(i).isSpace()) {
+            ++i;
+            continue;
+        }
+        const int tokenStart = i;
+
+        bool negated = false;
+        if (text.at(i) == QLatin1Char('-') && i + 1 < size && !text.at(i + 1).isSpace()) {
+            negated = true;
+            ++i;
+        }
+
+        // 字段名：紧跟冒号的一串字母
+        QString field;
+        int nameEnd = i;
+        while (nameEnd < size && text.at(nameEnd).isLetter()) {
+            ++nameEnd;
+        }
+        if (nameEnd > i && nameEnd < size && text.at(nameEnd) == QLatin1Char(':')) {
+            const QString name = text.mid(i, nameEnd - i).toLower();
+            if (isField(name)) {
+                field = name;
+                i = nameEnd + 1;
+            }
+        }
+
+        QString value;
+        bool quoted = false;
+        if (i < size && text.at(i) == QLatin1Char('"')) {
+            quoted = true;
+            int end = text.indexOf(QLatin1Char('"'), i + 1);
+            if (end < 0) {
+                end = size;
+            }
+            value = text.mid(i + 1, end - i - 1);
+            i = end + 1;
+        } else {
+            const int valueStart = i;
+            while (i < size && !text.at(i).isSpace()) {
+                ++i;
+            }
+            value = text.mid(valueStart, i - valueStart);
+        }
+        value = value.trimmed();
+        if (value.isEmpty()) {
+            continue;
+        }
+
+        if (field == QLatin1String("title")) {
+            (negated ? query.excludedTitleWords : query.titleWords).append(value);
+            continue;
+        }
+        if (field == QLatin1String("category")) {
+            (negated ? query.excludedCategory : query.category) = value;
+            continue;
+        }
+        bool pinned = false;
+        if (field == QLatin1String("pinned") && parsePinned(value, &pinned)) {
+            query.pinned = (pinned != negated) ? OnlyPinned : OnlyUnpinned;
+            continue;
+        }
+        QDateTime from;
+        QDateTime to;
+        if (field == QLatin1String("updated") && parseUpdated(value, &from, &to)) {
+            if (negated) {
+                query.excludedUpdated.append(qMakePair(from, to));
+            } else {
+                narrowUpdated(&query, from, to);
+            }
+            continue;
+        }
+        if (!field.isEmpty()) {
+            // 值无效：整个片段当作普通关键词
+            value = text.mid(tokenStart, qMin(i, size) - tokenStart);
+            negated = false;
+            quoted = false;
+        }
+
+        if (negated) {
+            (quoted ? query.excludedPhrases : query.excludedWords).append(value);
+        } else {
+            (quoted ? query.phrases : query.words).append(value);
+        }
+    }
+    return query;
+}
+
+/**
+ * @brief 是否用到了普通关键词以外的语法
+ * @return 有短语、排除或字段过滤时返回 true
+ */
+bool SearchQuery::hasFilters() const
+{
+    return !phrases.isEmpty() || !titleWords.isEmpty() || !excludedWords.isEmpty()
+            || !excludedPhrases.isEmpty() || !category.isEmpty() || pinned != AnyPinned
+            || updatedFrom.isValid() || updatedTo.isValid() || !excludedTitleWords.isEmpty()
+            || !excludedCategory.isEmpty() || !excludedUpdated.isEmpty();
+}
+
+/**
+ * @brief 查询是否为空
+ * @return 没有任何关键词和过滤条件时返回 true
+ */
+bool SearchQuery::isEmpty() const
+{
+    return words.isEmpty() && !hasFilters();
+}
@@ -0,0 +1,66 @@
+/**
+ * @file SearchQuery.h
+ * @brief 结构化搜索查询
+ *
+ * 知识点：
+ * - 手写的小型词法分析：空白分隔，双引号括起短语，- 表示排除
+ * - 字段过滤 field:value，值也可以用双引号括起来
+ * - 无法识别的字段按普通关键词处理，不会因为输入了冒号而搜不到
+ */
+
+#ifndef SEARCHQUERY_H
+#define SEARCHQUERY_H
+
+#include <QDateTime>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @struct SearchQuery
+ * @brief 解析后的搜索查询
+ *
+ * 支持的语法（各部分之间是“并且”关系）：
+ * - foo                普通关键词，按词匹配标题或正文
+ * - "exact phrase"     短语，整体出现在标题或正文中
+ * - -foo / -"a b"      排除包含该词/短语的笔记
+ * - title:foo          关键词必须出现在标题中
+ * - category:工作      属于该分类（含子分类），按名称匹配
+ * - pinned:true        只看置顶（false 只看未置顶）
+ * - updated:>2026-01-01  按修改日期过滤，支持 > >= < <= 和不带运算符的“当天”
+ * - -title:foo / -category:工作 / -updated:2026-01-01  排除标题含该词、属于该分类或修改日期在该范围内的笔记
+ */
+struct SearchQuery
+{
+    /**
+     * @brief 置顶过滤
+     */
+    enum PinnedFilter {
+        AnyPinned,      ///< 不过滤
+        OnlyPinned,     ///< 只看置顶
+        OnlyUnpinned    ///< 只看未置顶
+    };
+
+    QStringList words;              // 普通关键词
+    QStringList phrases;            // 短语
+    QStringList titleWords;         // 必须出现在标题中的关键词
+    QStringList excludedWords;      // 排除的关键词
+    QStringList excludedPhrases;    // 排除的短语
+    QString category;               // 分类名称（为空表示不过滤）
+    QStringList categoryIds;        // 分类名称对应的分类及其子分类（由 NoteManager 填入）
+    PinnedFilter pinned = AnyPinned;
+    QDateTime updatedFrom;          // 修改时间下限（包含），无效表示不限
+    QDateTime updatedTo;            // 修改时间上限（不包含），无效表示不限
+    QStringList excludedTitleWords; // 不能出现在标题中的关键词
+    QString excludedCategory;       // 排除的分类名称
+    QStringList excludedCategoryIds;    // 排除的分类及其子分类（由 NoteManager 填入）
+    QVector<QPair<QDateTime, QDateTime>> excludedUpdated;   // 排除的修改时间区间 [from, to)
+
+    static SearchQuery parse(const QString &text);
+
+    bool hasFilters() const;
+    bool isEmpty() const;
+};
+
+#endif // SEARCHQUERY_H
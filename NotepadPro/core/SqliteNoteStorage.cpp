@@ -0,0 +1,368 @@
+/**
+ * @file SqliteNoteStorage.cpp
+ * @brief SQLite 存储后端实现
+ *
+ * 知识点：
+ * - QSqlDatabase::addDatabase() 以连接名区分多个连接
+ * - QSqlQuery::prepare() + bindValue() 预编译语句，避免拼接 SQL
+ * - transaction()/commit()/rollback() 一批修改作为一个事务提交
+ * - PRAGMA journal_mode=WAL 开启预写日志模式
+ */
+
+#include "SqliteNoteStorage.h"
+
+#include <QFile>
+#include <QUuid>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+namespace {
+const char kSqliteMagic[] = "SQLite format 3";
+
+/**
+ * @brief 时间转换为毫秒数，无效时间存为 NULL
+ */
+QVariant toMSecs(const QDateTime &time)
+{
+    return time.isValid() ? QVariant(time.toMSecsSinceEpoch()) : QVariant();
+}
+
+/**
+ * @brief 毫秒数转换为时间
+ */
+QDateTime fromMSecs(const QVariant &value)
+{
+    return value.isNull() ? QDateTime() : QDateTime::fromMSecsSinceEpoch(value.toLongLong());
+}
+}
+
+/**
+ * @brief 构造函数
+ *
+ * 每个实例使用独立的连接名，可以同时打开多个数据库（例如导出时）
+ */
+SqliteNoteStorage::SqliteNoteStorage()
+    : m_connectionName("NotepadPro_" + QUuid::createUuid().toString(QUuid::WithoutBraces))
+{
+}
+
+/**
+ * @brief 析构函数
+ */
+SqliteNoteStorage::~SqliteNoteStorage()
+{
+    close();
+}
+
+/**
+ * @brief 打开（不存在时创建）数据库
+ * @param path 数据库文件路径
+ * @return 打开成功返回 true
+ */
+bool SqliteNoteStorage::open(const QString &path)
+{
+    close();
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+        db.setDatabaseName(path);
+        if (db.open()) {
+            QSqlQuery query(db);
+            query.exec("PRAGMA journal_mode=WAL");
+            query.exec("PRAGMA synchronous=NORMAL");
+            if (createSchema()) {
+                return true;
+            }
+        }
+    }
+    close();
+    return false;
+}
+
+/**
+ * @brief 关闭数据库并移除连接
+ *
+ * removeDatabase() 之前必须销毁所有引用该连接的 QSqlDatabase 对象
+ */
+void SqliteNoteStorage::close()
+{
+    if (!QSqlDatabase::contains(m_connectionName)) {
+        return;
+    }
+    {
+        QSqlDatabase db = database();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+/**
+ * @brief 数据库是否已打开
+ * @return 已打开返回 true
+ */
+bool SqliteNoteStorage::isOpen() const
+{
+    return QSqlDatabase::contains(m_connectionName) && database().isOpen();
+}
+
+/**
+ * @brief 读取全部笔记和分类
+ * @param notes 输出笔记记录
+ * @param categories 输出分类记录
+ * @return 读取成功返回 true
+ */
+bool SqliteNoteStorage::load(QList<NoteRecord> *notes, QList<CategoryRecord> *categories)
+{
+    QSqlQuery query(database());
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT id, title, content, categoryId, createdAt, updatedAt, isPinned "
+                    "FROM notes")) {
+        return false;
+    }
+    while (query.next()) {
+        NoteRecord record;
+        record.id = query.value(0).toString();
+        record.title = query.value(1).toString();
+        record.content = query.value(2).toString();
+        record.categoryId = query.value(3).toString();
+        record.createdAt = fromMSecs(query.value(4));
+        record.updatedAt = fromMSecs(query.value(5));
+        record.isPinned = query.value(6).toBool();
+        notes->append(record);
+    }
+
+    if (!query.exec("SELECT id, name, color, parentId FROM categories")) {
+        return false;
+    }
+    while (query.next()) {
+        CategoryRecord record;
+        record.id = query.value(0).toString();
+        record.name = query.value(1).toString();
+        record.color = QColor(query.value(2).toString());
+        record.parentId = query.value(3).toString();
+        categories->append(record);
+    }
+    return true;
+}
+
+/**
+ * @brief 用给定数据替换数据库的全部内容（格式切换、迁移时使用）
+ * @return 写入成功返回 true
+ */
+bool SqliteNoteStorage::saveAll(const QList<NoteRecord> &notes,
+                                const QList<CategoryRecord> &categories)
+{
+    QSqlDatabase db = database();
+    if (!db.transaction()) {
+        return false;
+    }
+
+    QSqlQuery query(db);
+    if (query.exec("DELETE FROM notes") && query.exec("DELETE FROM categories")
+            && writeNotes(notes) && writeCategories(categories)) {
+        return db.commit();
+    }
+    db.rollback();
+    return false;
+}
+
+/**
+ * @brief 在一个事务中写入变化的记录
+ * @param notes 新建或修改的笔记
+ * @param removedNoteIds 已删除的笔记ID
+ * @param categories 新建或修改的分类
+ * @param removedCategoryIds 已删除的分类ID
+ * @return 写入成功返回 true
+ *
+ * 写入量只与修改的记录数有关，与笔记总数无关
+ */
+bool SqliteNoteStorage::saveChanges(const QList<NoteRecord> &notes,
+                                    const QStringList &removedNoteIds,
+                                    const QList<CategoryRecord> &categories,
+                                    const QStringList &removedCategoryIds)
+{
+    QSqlDatabase db = database();
+    if (!db.transaction()) {
+        return false;
+    }
+
+    bool ok = writeNotes(notes) && writeCategories(categories);
+
+    QSqlQuery query(db);
+    if (ok && !removedNoteIds.isEmpty()) {
+        ok = query.prepare("DELETE FROM notes WHERE id = ?");
+        for (const QString &id : removedNoteIds) {
+            query.bindValue(0, id);
+            ok = ok && query.exec();
+        }
+    }
+    if (ok && !removedCategoryIds.isEmpty()) {
+        ok = query.prepare("DELETE FROM categories WHERE id = ?");
+        for (const QString &id : removedCategoryIds) {
+            query.bindValue(0, id);
+            ok = ok && query.exec();
+        }
+    }
+
+    if (ok && db.commit()) {
+        return true;
+    }
+    db.rollback();
+    return false;
+}
+
+/**
+ * @brief 查询某个分类下的笔记（使用 categoryId 索引）
+ * @param categoryId 分类ID
+ * @return 笔记ID列表
+ */
+QStringList SqliteNoteStorage::noteIdsByCategory(const QString &categoryId) const
+{
+    return queryIds("SELECT id FROM notes WHERE categoryId = ?", {categoryId});
+}
+
+/**
+ * @brief 按“置顶优先、最近修改优先”排序查询笔记
+ * @param categoryId 分类ID（为空表示全部笔记）
+ * @return 排好序的笔记ID列表
+ */
+QStringList SqliteNoteStorage::noteIdsPinnedFirst(const QString &categoryId) const
+{
+    if (categoryId.isEmpty()) {
+        return queryIds("SELECT id FROM notes ORDER BY isPinned DESC, updatedAt DESC", {});
+    }
+    return queryIds("SELECT id FROM notes WHERE categoryId = ? "
+                    "ORDER BY isPinned DESC, updatedAt DESC", {categoryId});
+}
+
+/**
+ * @brief 查询最近修改的笔记（使用 updatedAt 索引）
+ * @param limit 最多返回的数量
+ * @return 笔记ID列表
+ */
+QStringList SqliteNoteStorage::recentNoteIds(int limit) const
+{
+    return queryIds("SELECT id FROM notes ORDER BY updatedAt DESC LIMIT ?", {limit});
+}
+
+/**
+ * @brief 按文件头判断是否为 SQLite 数据库
+ * @param path 文件路径
+ * @return 是 SQLite 数据库返回 true
+ */
+bool SqliteNoteStorage::isSqliteFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return file.read(sizeof(kSqliteMagic)) == QByteArray(kSqliteMagic, sizeof(kSqliteMagic));
+}
+
+/**
+ * @brief 获取本实例的数据库连接
+ */
+QSqlDatabase SqliteNoteStorage::database() const
+{
+    return QSqlDatabase::database(m_connectionName, false);
+}
+
+/**
+ * @brief 创建表和索引（已存在时跳过）
+ */
+bool SqliteNoteStorage::createSchema()
+{
+    QSqlQuery query(database());
+    return query.exec("CREATE TABLE IF NOT EXISTS notes ("
+                      "id TEXT PRIMARY KEY, title TEXT, content TEXT, categoryId TEXT, "
+                      "createdAt INTEGER, updatedAt INTEGER, isPinned INTEGER NOT NULL DEFAULT 0)")
+            && query.exec("CREATE TABLE IF NOT EXISTS categories ("
+                          "id TEXT PRIMARY KEY, name TEXT, color TEXT, parentId TEXT)")
+            && query.exec("CREATE INDEX IF NOT EXISTS idx_notes_category "
+                          "ON notes (categoryId, isPinned, updatedAt)")
+            && query.exec("CREATE INDEX IF NOT EXISTS idx_notes_pinned "
+                          "ON notes (isPinned, updatedAt)")
+            && query.exec("CREATE INDEX IF NOT EXISTS idx_notes_updated "
+                          "ON notes (updatedAt)");
+}
+
+/**
+ * @brief 插入或覆盖笔记（需在事务中调用）
+ */
+bool SqliteNoteStorage::writeNotes(const QList<NoteRecord> &notes)
+{
+    if (notes.isEmpty()) {
+        return true;
+    }
+
+    QSqlQuery query(database());
+    if (!query.prepare("INSERT OR REPLACE INTO notes "
+                       "(id, title, content, categoryId, createdAt, updatedAt, isPinned) "
+                       "VALUES (?, ?, ?, ?, ?, ?, ?)")) {
+        return false;
+    }
+    for (const NoteRecord &note : notes) {
+        query.bindValue(0, note.id);
+        query.bindValue(1, note.title);
+        query.bindValue(2, note.loadContent());
+        query.bindValue(3, note.categoryId);
+        query.bindValue(4, toMSecs(note.createdAt));
+        query.bindValue(5, toMSecs(note.updatedAt));
+        query.bindValue(6, note.isPinned ? 1 : 0);
+        if (!query.exec()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 插入或覆盖分类（需在事务中调用）
+ */
+bool SqliteNoteStorage::writeCategories(const QList<CategoryRecord> &categories)
+{
+    if (categories.isEmpty()) {
+        return true;
+    }
+
+    QSqlQuery query(database());
+    if (!query.prepare("INSERT OR REPLACE INTO categories (id, name, color, parentId) "
+                       "VALUES (?, ?, ?, ?)")) {
+        return false;
+    }
+    for (const CategoryRecord &cat : categories) {
+        query.bindValue(0, cat.id);
+        query.bindValue(1, cat.name);
+        query.bindValue(2, cat.color.name());
+        query.bindValue(3, cat.parentId);
+        if (!query.exec()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 执行只返回笔记ID的查询
+ * @param sql 带 ? 占位符的 SQL
+ * @param values 按顺序绑定的参数
+ * @return 笔记ID列表
+ */
+QStringList SqliteNoteStorage::queryIds(const QString &sql, const QVariantList &values) const
+{
+    QStringList ids;
+    QSqlQuery query(database());
+    query.setForwardOnly(true);
+    if (!query.prepare(sql)) {
+        return ids;
+    }
+    for (int i = 0; i < values.size(); ++i) {
+        query.bindValue(i, values.at(i));
+    }
+    if (query.exec()) {
+        while (query.next()) {
+            ids.append(query.value(0).toString());
+        }
+    }
+    return ids;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file SqliteNoteStorage.h
+ * @brief SQLite 存储后端
+ *
+ * 知识点：
+ * - Qt Sql 模块与内置的 QSQLITE 驱动
+ * - WAL（预写日志）模式：写入不阻塞读取，提交只追加日志
+ * - 索引把按分类/置顶/时间的查询从全表扫描变为索引查找
+ */
+
+#ifndef SQLITENOTESTORAGE_H
+#define SQLITENOTESTORAGE_H
+
+#include <QVariant>
+
+#include "NoteStorage.h"
+
+class QSqlDatabase;
+
+/**
+ * @class SqliteNoteStorage
+ * @brief 把笔记和分类保存在 SQLite 数据库中
+ *
+ * 表结构：
+ * - notes(id, title, content, categoryId, createdAt, updatedAt, isPinned)
+ * - categories(id, name, color, parentId)
+ *
+ * 时间戳保存为毫秒数（INTEGER），便于建立索引和排序
+ */
+class SqliteNoteStorage : public NoteStorage
+{
+public:
+    SqliteNoteStorage();
+    ~SqliteNoteStorage() override;
+
+    // NoteStorage 接口
+    bool open(const QString &path) override;
+    void close() override;
+    bool isOpen() const override;
+
+    bool load(QList<NoteRecord> *notes, QList<CategoryRecord> *categories) override;
+    bool saveAll(const QList<NoteRecord> &notes,
+                 const QList<CategoryRecord> &categories) override;
+    bool saveChanges(const QList<NoteRecord> &notes, const QStringList &removedNoteIds,
+                     const QList<CategoryRecord> &categories,
+                     const QStringList &removedCategoryIds) override;
+
+    QStringList noteIdsByCategory(const QString &categoryId) const override;
+    QStringList noteIdsPinnedFirst(const QString &categoryId) const override;
+    QStringList recentNoteIds(int limit) const override;
+
+    static bool isSqliteFile(const QString &path);
+
+private:
+    Q_DISABLE_COPY(SqliteNoteStorage)
+
+    QSqlDatabase database() const;
+    bool createSchema();
+    bool writeNotes(const QList<NoteRecord> &notes);
+    bool writeCategories(const QList<CategoryRecord> &categories);
+    QStringList queryIds(const QString &sql, const QVariantList &values) const;
+
+    QString m_connectionName;
+};
+
+#endif // SQLITENOTESTORAGE_H
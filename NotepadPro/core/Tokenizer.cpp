@@ -0,0 +1,149 @@
+/**
+ * @file Tokenizer.cpp
+ * @brief 全文搜索分词实现
+ *
+ * 知识点：
+ * - 单遍扫描，按码点（code point）处理，代理对（surrogate pair）不会被拆开
+ * - QChar::script() 判断文字体系，汉字/假名/谚文按字切分
+ * - 中文没有空格分词，用“单字 + 相邻两字（bigram）”建索引，不需要词典
+ */
+
+#include "Tokenizer.h"
+
+#include <QVector>
+
+namespace {
+/**
+ * @brief 字符类别
+ */
+enum CharClass {
+    Separator,  ///< 标点、空白等
+    Word,       ///< 字母、数字（拉丁文、西里尔文等以空格分词的文字）
+    Cjk         ///< 汉字、假名、谚文
+};
+
+/**
+ * @brief 判断一个码点的类别
+ */
+CharClass classify(uint ucs4)
+{
+    switch (QChar::script(ucs4)) {
+    case QChar::Script_Han:
+    case QChar::Script_Hiragana:
+    case QChar::Script_Katakana:
+    case QChar::Script_Hangul:
+    case QChar::Script_Bopomofo:
+        return QChar::isLetterOrNumber(ucs4) ? Cjk : Separator;
+    default:
+        return QChar::isLetterOrNumber(ucs4) ? Word : Separator;
+    }
+}
+
+/**
+ * @brief 码点转字符串（大小写折叠）
+ */
+QString foldedString(uint ucs4)
+{
+    const uint folded = QChar::toCaseFolded(ucs4);
+    if (QChar::requiresSurrogates(folded)) {
+        const QChar pair[2] = { QChar(QChar::highSurrogate(folded)),
+                                QChar(QChar::lowSurrogate(folded)) };
+        return QString(pair, 2);
+    }
+    return QString(QChar(folded));
+}
+
+/**
+ * @brief 输出一段连续的 CJK 字符：每个单字，以及每两个相邻字组成的 bigram
+ *
+ * 查询时两字以上的片段只需要 bigram：单字已经被相邻的 bigram 覆盖，
+ * 而单字的 posting list 通常很长，省掉它能减少求交集的工作量
+ */
+void emitCjkRun(const QVector<QString> &chars, Tokenizer::Mode mode, QStringList *tokens)
+{
+    const bool unigrams = mode == Tokenizer::IndexMode || chars.size() == 1;
+    for (int i = 0; i < chars.size(); ++i) {
+        if (unigrams) {
+            tokens->append(chars.at(i));
+        }
+        if (i + 1 < chars.size()) {
+            tokens->append(chars.at(i) + chars.at(i + 1));
+        }
+    }
+}
+}
+
+/**
+ * @brief 切分文本
+ * @param text 纯文本
+ * @param mode 建索引或解析查询
+ * @return 大小写折叠后的词（按出现顺序，可能重复）
+ *
+ * 拉丁文等按连续的字母/数字切成单词；
+ * 连续的 CJK 字符输出单字和相邻两字，例如“笔记本”输出 笔、笔记、记、记本、本
+ */
+QStringList Tokenizer::tokenize(const QString &text, Mode mode)
+{
+    QStringList tokens;
+    QString word;
+    QVector<QString> cjkRun;
+
+    auto flushWord = [&tokens, &word]() {
+        if (!word.isEmpty()) {
+            tokens.append(word.left(MaxTokenLength));
+            word.clear();
+        }
+    };
+    auto flushCjk = [&tokens, &cjkRun, mode]() {
+        if (!cjkRun.isEmpty()) {
+            emitCjkRun(cjkRun, mode, &tokens);
+            cjkRun.clear();
+        }
+    };
+
+    const int size = text.size();
+    for (int i = 0; i < size; ++i) {
+        uint ucs4 = text.at(i).unicode();
+        if (QChar::isHighSurrogate(ucs4) && i + 1 < size && text.at(i + 1).isLowSurrogate()) {
+            ucs4 = QChar::surrogateToUcs4(text.at(i), text.at(i + 1));
+            ++i;
+        }
+
+        switch (classify(ucs4)) {
+        case Word:
+            flushCjk();
+            word += foldedString(ucs4);
+            break;
+        case Cjk:
+            flushWord();
+            cjkRun.append(foldedString(ucs4));
+            break;
+        case Separator:
+            flushWord();
+            flushCjk();
+            break;
+        }
+    }
+    flushWord();
+    flushCjk();
+    return tokens;
+}
+
+/**
+ * @brief 词是否来自 CJK 文字（单字或 bigram）
+ * @param token tokenize() 输出的词
+ * @return 是返回 true
+ *
+ * CJK 词的长度固定，查询时按整词匹配；其他词按前缀匹配
+ */
+bool Tokenizer::isCjkToken(const QString &token)
+{
+    if (token.isEmpty()) {
+        return false;
+    }
+    uint ucs4 = token.at(0).unicode();
+    if (token.size() > 1 && token.at(0).isHighSurrogate()) {
+        ucs4 = QChar::surrogateToUcs4(token.at(0), token.at(1));
+    }
+    return classify(ucs4) == Cjk;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file Tokenizer.h
+ * @brief 全文搜索分词
+ *
+ * 知识点：
+ * - QChar::isLetterOrNumber() 按 Unicode 字符类别判断单词字符
+ * - QChar::toCaseFolded() 大小写折叠，用于不区分大小写的比较
+ * - 中日韩文字没有空格分隔，按单字和相邻两字（bigram）切分
+ */
+
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * @class Tokenizer
+ * @brief 把纯文本切分为索引词
+ *
+ * 建索引和解析查询使用同一套规则，保证查询词与索引词可以直接比较
+ */
+class Tokenizer
+{
+public:
+    /**
+     * @brief 切分用途
+     */
+    enum Mode {
+        IndexMode,  ///< 建索引：CJK 输出全部单字和 bigram
+        QueryMode   ///< 解析查询：两字以上的 CJK 片段只输出 bigram
+    };
+
+    /// 单个词的最大长度，超长部分截断（避免 base64 等长串撑大词典）
+    static constexpr int MaxTokenLength = 32;
+
+    static QStringList tokenize(const QString &text, Mode mode = IndexMode);
+    static bool isCjkToken(const QString &token);
+};
+
+#endif // TOKENIZER_H
@@ -0,0 +1,310 @@
+/**
+ * @file TrigramIndex.cpp
+ * @brief 三字符片段（trigram）索引实现
+ *
+ * 知识点：
+ * - QString::toCaseFolded() 折叠整段文本
+ * - 从正则表达式中提取“必定出现”的字面量片段，用来缩小候选范围
+ */
+
+#include "TrigramIndex.h"
+
+#include <QDataStream>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace {
+// 已删除的编号超过未删除文档数的这个比例（且不少于 kMinPurgeCount 个）时清理 posting list
+const int kPurgeDivisor = 4;
+const int kMinPurgeCount = 256;
+}
+
+/**
+ * @brief 构造函数
+ */
+TrigramIndex::TrigramIndex()
+    : m_documentCount(0)
+{
+}
+
+/**
+ * @brief 索引一个文档
+ * @param docId 文档编号（大于所有已索引的编号）
+ * @param text 文档文本
+ */
+void TrigramIndex::addDocument(quint32 docId, const QString &text)
+{
+    const QVector<quint64> trigrams = trigramsOf(text);
+    for (quint64 trigram : trigrams) {
+        m_postings[trigram].append(docId);
+    }
+    ++m_documentCount;
+}
+
+/**
+ * @brief 移除一个文档
+ * @param docId 文档编号
+ *
+ * 不需要文档文本：编号先记为已删除，由 purgeRemoved() 批量从列表中清除
+ */
+void TrigramIndex::removeDocument(quint32 docId)
+{
+    m_removed.insert(docId);
+    --m_documentCount;
+    if (m_removed.size() >= qMax(kMinPurgeCount, m_documentCount / kPurgeDivisor)) {
+        purgeRemoved();
+    }
+}
+
+/**
+ * @brief 从所有 posting list 中清除已删除的文档编号
+ *
+ * 遍历一遍全部列表，代价分摊到多次删除上；不含已删除编号的列表不修改，
+ * 与工作线程中的索引副本继续共享
+ */
+void TrigramIndex::purgeRemoved()
+{
+    auto isRemoved = [this](quint32 docId) { return m_removed.contains(docId); };
+    for (auto it = m_postings.begin(); it != m_postings.end();) {
+        const PostingList &list = std::as_const(it.value());
+        if (std::none_of(list.constBegin(), list.constEnd(), isRemoved)) {
+            ++it;
+            continue;
+        }
+        PostingList &mutableList = it.value();
+        mutableList.erase(std::remove_if(mutableList.begin(), mutableList.end(), isRemoved),
+                          mutableList.end());
+        it = mutableList.isEmpty() ? m_postings.erase(it) : std::next(it);
+    }
+    m_removed.clear();
+}
+
+/**
+ * @brief 清空索引
+ */
+void TrigramIndex::clear()
+{
+    m_postings.clear();
+    m_removed.clear();
+    m_documentCount = 0;
+}
+
+/**
+ * @brief 按新旧编号对照表重新编号
+ * @param newIds 旧编号 → 新编号（保持顺序）；不在表中的文档（包括已删除的）被丢弃
+ */
+void TrigramIndex::renumber(const QHash<quint32, quint32> &newIds)
+{
+    for (auto it = m_postings.begin(); it != m_postings.end();) {
+        PostingList renumbered;
+        for (quint32 docId : std::as_const(it.value())) {
+            const auto idIt = newIds.constFind(docId);
+            if (idIt != newIds.constEnd()) {
+                renumbered.append(idIt.value());
+            }
+        }
+        if (renumbered.isEmpty()) {
+            it = m_postings.erase(it);
+        } else {
+            it.value() = renumbered;
+            ++it;
+        }
+    }
+    m_removed.clear();
+}
+
+/**
+ * @brief 写出全部 posting list 和已删除的文档编号
+ * @param out 数据流
+ */
+void TrigramIndex::write(QDataStream &out) const
+{
+    out << qint32(m_documentCount) << m_removed << m_postings;
+}
+
+/**
+ * @brief 读入 write() 写出的数据
+ * @param in 数据流（读取失败时由调用方检查流状态）
+ */
+void TrigramIndex::read(QDataStream &in)
+{
+    qint32 documentCount = 0;
+    in >> documentCount >> m_removed >> m_postings;
+    m_documentCount = documentCount;
+}
+
+/**
+ * @brief 可能包含某个子串的文档
+ * @param literal 子串
+ * @param result 输出候选文档编号（有序）
+ * @return 子串不足 3 个字符、无法用索引缩小范围时返回 false（此时全部文档都是候选）
+ */
+bool TrigramIndex::candidates(const QString &literal, PostingList *result) const
+{
+    QVector<quint64> trigrams = trigramsOf(literal);
+    if (trigrams.isEmpty()) {
+        return false;
+    }
+
+    // 先取最短的列表，再依次求交集
+    std::sort(trigrams.begin(), trigrams.end(), [this](quint64 a, quint64 b) {
+        return m_postings.value(a).size() < m_postings.value(b).size();
+    });
+    *result = m_postings.value(trigrams.first());
+    for (int i = 1; i < trigrams.size() && !result->isEmpty(); ++i) {
+        const PostingList other = m_postings.value(trigrams.at(i));
+        PostingList merged;
+        std::set_intersection(result->constBegin(), result->constEnd(),
+                              other.constBegin(), other.constEnd(), std::back_inserter(merged));
+        *result = merged;
+    }
+    if (!m_removed.isEmpty()) {
+        result->erase(std::remove_if(result->begin(), result->end(), [this](quint32 docId) {
+                          return m_removed.contains(docId);
+                      }), result->end());
+    }
+    return true;
+}
+
+/**
+ * @brief 提取正则表达式中每次匹配都必须出现的字面量片段
+ * @param pattern 正则表达式
+ * @return 字面量片段；无法确定时返回空列表（只能全量验证）
+ *
+ * 保守分析，只取最外层、不受量词影响的连续普通字符：
+ * - 含有 | 时任何片段都不是必须的，直接放弃
+ * - 分组、字符类、. ^ $ 和 \\d 等转义会切断片段
+ * - ? * {n,m} 使前一个字符可有可无（或重复次数不定），把它从片段中去掉，
+ *   整个 {n} / {n,m} 一起跳过：\\d{4}-\\d{2} 没有必需片段，abc{0,3}defg 只得到 "defg"
+ * - 不构成量词的 { 按普通字符处理（与 PCRE 相同）
+ */
+QStringList TrigramIndex::requiredLiterals(const QString &pattern)
+{
+    QStringList literals;
+    QString current;
+    int groupDepth = 0;
+
+    auto flush = [&literals, &current]() {
+        if (current.size() >= 3) {
+            literals.append(current);
+        }
+        current.clear();
+    };
+
+    for (int i = 0; i < pattern.size(); ++i) {
+        const QChar ch = pattern.at(i);
+        switch (ch.unicode()) {
+        case '|':
+            return QStringList();
+        case '\\': {
+            if (i + 1 >= pattern.size()) {
+                return QStringList();
+            }
+            const QChar next = pattern.at(++i);
+            if (next == QLatin1Char('Q')) {
+                return QStringList();
+            }
+            if (next.isLetterOrNumber()) {
+                flush();        // \d \w \b \1 等
+            } else if (groupDepth == 0) {
+                current += next; // \. \( 等转义的普通字符
+            }
+            break;
+        }
+        case '[': {
+            flush();
+            // 跳过字符类，] 紧跟在 [ 或 [^ 后面时是普通字符
+            int j = i + 1;
+            if (j < pattern.size() && pattern.at(j) == QLatin1Char('^')) {
+                ++j;
+            }
+            if (j < pattern.size() && pattern.at(j) == QLatin1Char(']')) {
+                ++j;
+            }
+            while (j < pattern.size() && pattern.at(j) != QLatin1Char(']')) {
+                if (pattern.at(j) == QLatin1Char('\\')) {
+                    ++j;
+                }
+                ++j;
+            }
+            i = j;
+            break;
+        }
+        case '(':
+            flush();
+            ++groupDepth;
+            break;
+        case ')':
+            flush();
+            groupDepth = qMax(0, groupDepth - 1);
+            break;
+        case '{': {
+            // 只有 {n} {n,} {n,m} 是量词，跳到对应的 }
+            int j = i + 1;
+            while (j < pattern.size() && pattern.at(j).isDigit()) {
+                ++j;
+            }
+            if (j < pattern.size() && pattern.at(j) == QLatin1Char(',')) {
+                ++j;
+                while (j < pattern.size() && pattern.at(j).isDigit()) {
+                    ++j;
+                }
+            }
+            // {,m} 在较新的 PCRE 中也是量词，同样跳过（少取片段只会多验证几篇，不会漏掉）
+            if (j == i + 1 || j >= pattern.size() || pattern.at(j) != QLatin1Char('}')) {
+                if (groupDepth == 0) {
+                    current += ch;
+                }
+                break;
+            }
+            current.chop(1);
+            flush();
+            i = j;
+            break;
+        }
+        case '?':
+        case '*':
+            current.chop(1);
+            flush();
+            break;
+        case '+':
+        case '.':
+        case '^':
+        case '$':
+            flush();
+            break;
+        default:
+            if (groupDepth == 0) {
+                current += ch;
+            }
+            break;
+        }
+    }
+    flush();
+    return literals;
+}
+
+/**
+ * @brief 文本的全部 trigram（折叠大小写，去重）
+ */
+QVector<quint64> TrigramIndex::trigramsOf(const QString &text)
+{
+    const QString folded = text.toCaseFolded();
+    QVector<quint64> trigrams;
+    if (folded.size() < 3) {
+        return trigrams;
+    }
+
+    trigrams.reserve(folded.size() - 2);
+    const QChar *data = folded.constData();
+    for (int i = 0; i + 2 < folded.size(); ++i) {
+        trigrams.append((quint64(data[i].unicode()) << 32)
+                        | (quint64(data[i + 1].unicode()) << 16)
+                        | quint64(data[i + 2].unicode()));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
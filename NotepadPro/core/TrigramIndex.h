@@ -0,0 +1,62 @@
+/**
+ * @file TrigramIndex.h
+ * @brief 三字符片段（trigram）索引
+ *
+ * 知识点：
+ * - 任意长度 >= 3 的子串都包含它自己的全部 trigram，
+ *   因此“包含全部 trigram”的文档集合一定覆盖真正包含该子串的文档
+ * - 用索引缩小候选范围，再逐条验证，结果与直接扫描完全相同
+ * - 三个 UTF-16 码元打包成一个 64 位整数作为哈希键
+ */
+
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QDataStream;
+
+/**
+ * @class TrigramIndex
+ * @brief trigram → 文档编号列表
+ *
+ * 文档编号由调用方（SearchIndex）分配，必须递增，posting list 因此保持有序。
+ * 文本在建索引前做大小写折叠，候选集对区分和不区分大小写的匹配都成立。
+ *
+ * 调用方不保存文档文本，移除文档时无法找回它的 trigram：
+ * 只把编号记为已删除，查询时过滤掉，已删除的编号积累到一定比例后一次性清理所有列表
+ */
+class TrigramIndex
+{
+public:
+    using PostingList = QVector<quint32>;
+
+    TrigramIndex();
+
+    void addDocument(quint32 docId, const QString &text);
+    void removeDocument(quint32 docId);
+    void clear();
+    void renumber(const QHash<quint32, quint32> &newIds);
+
+    bool candidates(const QString &literal, PostingList *result) const;
+
+    static QStringList requiredLiterals(const QString &pattern);
+
+    // 持久化（由 SearchIndex 调用）
+    void write(QDataStream &out) const;
+    void read(QDataStream &in);
+
+private:
+    static QVector<quint64> trigramsOf(const QString &text);
+    void purgeRemoved();
+
+    QHash<quint64, PostingList> m_postings;
+    QSet<quint32> m_removed;    // 已删除、但仍留在 posting list 中的文档编号
+    int m_documentCount;        // 未删除的文档数
+};
+
+#endif // TRIGRAMINDEX_H
@@ -4,13 +4,11 @@
  */
 
 #include "NotePropertiesDialog.h"
-#include "Note.h"
 #include "NoteManager.h"
 #include "Category.h"
 
 NotePropertiesDialog::NotePropertiesDialog(QWidget *parent)
     : QDialog(parent)
-    , m_note(nullptr)
 {
     setWindowTitle(tr("笔记属性"));
     setMinimumWidth(350);
@@ -62,26 +60,26 @@ void NotePropertiesDialog::updateCategoryCombo()
     }
 }
 
-void NotePropertiesDialog::setNote(Note *note)
+void NotePropertiesDialog::setNoteId(const QString &noteId)
 {
-    m_note = note;
-    if (!note) return;
+    NoteManager *manager = NoteManager::instance();
+    m_noteId = noteId;
+    if (!manager->hasNote(noteId)) return;
 
-    m_titleEdit->setText(note->title());
+    m_titleEdit->setText(manager->noteTitle(noteId));
 
     // 设置分类
-    int index = m_categoryCombo->findData(note->categoryId());
+    int index = m_categoryCombo->findData(manager->noteCategoryId(noteId));
     if (index >= 0) {
         m_categoryCombo->setCurrentIndex(index);
     }
 
     // 显示时间信息
-    m_createdLabel->setText(note->createdAt().toString("yyyy-MM-dd hh:mm:ss"));
-    m_modifiedLabel->setText(note->updatedAt().toString("yyyy-MM-dd hh:mm:ss"));
+    m_createdLabel->setText(manager->noteCreatedAt(noteId).toString("yyyy-MM-dd hh:mm:ss"));
+    m_modifiedLabel->setText(manager->noteUpdatedAt(noteId).toString("yyyy-MM-dd hh:mm:ss"));
 
-    // 计算字数
-    QString plainText = note->content();
-    int wordCount = plainText.length();
+    // 计算字数（纯文本，不含 HTML 标签）
+    int wordCount = manager->notePlainText(noteId).length();
     m_wordCountLabel->setText(QString::number(wordCount));
 }
 
@@ -19,8 +19,6 @@
 #include <QDialogButtonBox>
 #include <QVBoxLayout>
 
-class Note;
-
 /**
  * @class NotePropertiesDialog
  * @brief 笔记属性对话框
@@ -35,7 +33,7 @@ public:
     explicit NotePropertiesDialog(QWidget *parent = nullptr);
     ~NotePropertiesDialog() override = default;
 
-    void setNote(Note *note);
+    void setNoteId(const QString &noteId);
     QString noteTitle() const;
     QString categoryId() const;
 
@@ -58,7 +56,7 @@ private:
     QLabel *m_wordCountLabel;
 
     QDialogButtonBox *m_buttonBox;
-    Note *m_note;
+    QString m_noteId;
 };
 
 #endif // NOTEPROPERTIESDIALOG_H
@@ -50,7 +50,26 @@ void SettingsDialog::createGeneralTab()
     formLayout->addRow(m_autoSaveCheck);
     formLayout->addRow(tr("保存间隔:"), m_autoSaveIntervalSpin);
 
+    QGroupBox *storageGroup = new QGroupBox(tr("数据存储"), tab);
+    QFormLayout *storageLayout = new QFormLayout(storageGroup);
+
+    m_storageFormatCombo = new QComboBox(storageGroup);
+    m_storageFormatCombo->addItem(tr("JSON 文本"), "json");
+    m_storageFormatCombo->addItem(tr("二进制快照（快速加载）"), "binary");
+    m_storageFormatCombo->addItem(tr("目录（每条笔记一个文件）"), "directory");
+    m_storageFormatCombo->addItem(tr("SQLite 数据库"), "sqlite");
+
+    m_journalCheck = new QCheckBox(tr("增量日志保存（只写入修改部分）"), storageGroup);
+    m_lazyContentCheck = new QCheckBox(tr("按需加载笔记正文（二进制快照/目录，重启后生效）"), storageGroup);
+    m_compressCheck = new QCheckBox(tr("压缩二进制快照中的笔记正文"), storageGroup);
+
+    storageLayout->addRow(tr("数据格式:"), m_storageFormatCombo);
+    storageLayout->addRow(m_journalCheck);
+    storageLayout->addRow(m_lazyContentCheck);
+    storageLayout->addRow(m_compressCheck);
+
     layout->addWidget(autoSaveGroup);
+    layout->addWidget(storageGroup);
     layout->addStretch();
 
     m_tabWidget->addTab(tab, tr("常规"));
@@ -98,6 +117,11 @@ void SettingsDialog::loadSettings()
     // 常规设置
     m_autoSaveCheck->setChecked(settings.value("autoSave/enabled", false).toBool());
     m_autoSaveIntervalSpin->setValue(settings.value("autoSave/interval", 5).toInt());
+    int formatIndex = m_storageFormatCombo->findData(settings.value("storage/format", "json"));
+    m_storageFormatCombo->setCurrentIndex(qMax(0, formatIndex));
+    m_journalCheck->setChecked(settings.value("storage/journal", false).toBool());
+    m_lazyContentCheck->setChecked(settings.value("storage/lazyContent", false).toBool());
+    m_compressCheck->setChecked(settings.value("storage/compress", false).toBool());
 
     // 编辑器设置
     m_fontFamilyCombo->setCurrentText(settings.value("editor/fontFamily", "Microsoft YaHei").toString());
@@ -112,6 +136,10 @@ void SettingsDialog::saveSettings()
     // 常规设置
     settings.setValue("autoSave/enabled", m_autoSaveCheck->isChecked());
     settings.setValue("autoSave/interval", m_autoSaveIntervalSpin->value());
+    settings.setValue("storage/format", m_storageFormatCombo->currentData());
+    settings.setValue("storage/journal", m_journalCheck->isChecked());
+    settings.setValue("storage/lazyContent", m_lazyContentCheck->isChecked());
+    settings.setValue("storage/compress", m_compressCheck->isChecked());
 
     // 编辑器设置
     settings.setValue("editor/fontFamily", m_fontFamilyCombo->currentText());
@@ -54,6 +54,12 @@ private:
     QCheckBox *m_autoSaveCheck;
     QSpinBox *m_autoSaveIntervalSpin;
 
+    // 存储设置
+    QComboBox *m_storageFormatCombo;
+    QCheckBox *m_journalCheck;
+    QCheckBox *m_lazyContentCheck;
+    QCheckBox *m_compressCheck;
+
     // 编辑器设置
     QComboBox *m_fontFamilyCombo;
     QSpinBox *m_fontSizeSpin;
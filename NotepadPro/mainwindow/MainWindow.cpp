@@ -36,6 +36,9 @@
 #include <QSettings>
 #include <QRegularExpression>
 #include <QInputDialog>
+#include <QFileDialog>
+#include <QProgressDialog>
+#include <QSignalBlocker>
 
 /**
  * @brief 构造函数
@@ -117,6 +120,14 @@ void MainWindow::createMenuBar()
 
     m_fileMenu->addSeparator();
 
+    m_importAction = new QAction(tr("导入(&I)..."), this);
+    m_fileMenu->addAction(m_importAction);
+
+    m_exportAction = new QAction(tr("导出(&E)..."), this);
+    m_fileMenu->addAction(m_exportAction);
+
+    m_fileMenu->addSeparator();
+
     m_settingsAction = new QAction(tr("设置(&P)..."), this);
     m_fileMenu->addAction(m_settingsAction);
 
@@ -244,6 +255,10 @@ void MainWindow::connectSignals()
             this, &MainWindow::onSaveNote);
     connect(m_deleteNoteAction, &QAction::triggered,
             this, &MainWindow::onDeleteNote);
+    connect(m_importAction, &QAction::triggered,
+            this, &MainWindow::onImportData);
+    connect(m_exportAction, &QAction::triggered,
+            this, &MainWindow::onExportData);
     connect(m_settingsAction, &QAction::triggered,
             this, &MainWindow::onShowSettings);
     connect(m_exitAction, &QAction::triggered,
@@ -293,6 +308,13 @@ void MainWindow::connectSignals()
     // 搜索
     connect(m_searchWidget, &SearchWidget::searchRequested,
             this, &MainWindow::onSearchRequested);
+    // 输入变化后正在进行的搜索已经过时，等新的搜索请求前先取消
+    connect(m_searchWidget, &SearchWidget::searchTextChanged,
+            NoteManager::instance(), &NoteManager::cancelSearch);
+    connect(NoteManager::instance(), &NoteManager::searchResultsAvailable,
+            this, &MainWindow::onSearchResultsAvailable);
+    connect(NoteManager::instance(), &NoteManager::searchFinished,
+            this, &MainWindow::onSearchFinished);
 
     // 编辑器
     connect(m_editor, &RichTextEditor::textChanged,
@@ -301,6 +323,14 @@ void MainWindow::connectSignals()
     // 自动保存
     connect(m_autoSaveTimer, &QTimer::timeout,
             this, &MainWindow::onAutoSave);
+
+    // 保存在后台完成，结果通过信号通知
+    connect(NoteManager::instance(), &NoteManager::dataSaved, this, [this]() {
+        m_statusWidget->showMessage(tr("笔记已保存"));
+    });
+    connect(NoteManager::instance(), &NoteManager::saveFailed, this, [this]() {
+        m_statusWidget->showMessage(tr("保存失败"));
+    });
 }
 
 void MainWindow::loadSettings()
@@ -316,6 +346,8 @@ void MainWindow::loadSettings()
         m_autoSaveTimer->setInterval(interval * 60 * 1000);
         m_autoSaveTimer->start();
     }
+
+    applyStorageSettings();
 }
 
 void MainWindow::saveSettings()
@@ -325,6 +357,32 @@ void MainWindow::saveSettings()
     settings.setValue("mainWindow/state", saveState());
 }
 
+/**
+ * @brief 应用存储设置
+ *
+ * 启动时在加载数据之前调用；设置对话框确认后再次调用使修改立即生效
+ */
+void MainWindow::applyStorageSettings()
+{
+    QSettings settings;
+    NoteManager *manager = NoteManager::instance();
+
+    // 先设置压缩选项，切换格式时的迁移写入也会使用它
+    manager->setCompressionEnabled(settings.value("storage/compress", false).toBool());
+    QString format = settings.value("storage/format", "json").toString();
+    if (format == "binary") {
+        manager->setStorageFormat(NoteManager::BinaryFormat);
+    } else if (format == "directory") {
+        manager->setStorageFormat(NoteManager::DirectoryFormat);
+    } else if (format == "sqlite") {
+        manager->setStorageFormat(NoteManager::SqliteFormat);
+    } else {
+        manager->setStorageFormat(NoteManager::JsonFormat);
+    }
+    manager->setJournalEnabled(settings.value("storage/journal", false).toBool());
+    manager->setLazyContentEnabled(settings.value("storage/lazyContent", false).toBool());
+}
+
 void MainWindow::updateWindowTitle()
 {
     QString title = tr("NotepadPro");
@@ -339,7 +397,7 @@ void MainWindow::updateWindowTitle()
 
 void MainWindow::updateStatusBar()
 {
-    int noteCount = NoteManager::instance()->getAllNotes().count();
+    int noteCount = NoteManager::instance()->noteCount();
     int categoryCount = NoteManager::instance()->getAllCategories().count();
     m_statusWidget->setNoteCount(noteCount);
     m_statusWidget->setCategoryCount(categoryCount);
@@ -361,18 +419,18 @@ void MainWindow::closeEvent(QCloseEvent *event)
     }
 
     NoteManager::instance()->saveToFile();
+    NoteManager::instance()->saveSearchIndex();
+    NoteManager::instance()->waitForPendingSaves();
     event->accept();
 }
 
 void MainWindow::onNewNote()
 {
-    Note *note = NoteManager::instance()->createNote();
-    note->setTitle(tr("新建笔记"));
-    note->setCategoryId(m_currentCategoryId);
+    const QString noteId = NoteManager::instance()->createNote(tr("新建笔记"), m_currentCategoryId);
 
-    m_noteList->addNote(note);
-    m_noteList->setCurrentNoteId(note->id());
-    onNoteSelected(note->id());
+    m_noteList->addNote(noteId);
+    m_noteList->setCurrentNoteId(noteId);
+    onNoteSelected(noteId);
     updateStatusBar();
 }
 
@@ -384,7 +442,6 @@ void MainWindow::onSaveNote()
     m_editor->setModified(false);
     NoteManager::instance()->saveToFile();
     updateWindowTitle();
-    m_statusWidget->showMessage(tr("笔记已保存"));
 }
 
 void MainWindow::onDeleteNote()
@@ -408,6 +465,72 @@ void MainWindow::onDeleteNote()
     }
 }
 
+/**
+ * @brief 从 JSON 文件导入笔记和分类
+ *
+ * 导入为合并操作，导入后刷新分类树和笔记列表
+ */
+void MainWindow::onImportData()
+{
+    QString path = QFileDialog::getOpenFileName(this, tr("导入"),
+        QString(), tr("JSON 文件 (*.json)"));
+    if (path.isEmpty()) return;
+
+    QProgressDialog progress(tr("正在导入..."), tr("取消"), 0, 100, this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+    bool ok = NoteManager::instance()->importFromJson(path, [&progress](qint64 done, qint64 total) {
+        progress.setValue(total > 0 ? int(done * 100 / total) : 100);
+        return !progress.wasCanceled();
+    });
+    const bool canceled = progress.wasCanceled();
+    progress.reset();
+
+    if (canceled) {
+        m_statusWidget->showMessage(tr("导入已取消"));
+        return;
+    }
+    if (!ok) {
+        QMessageBox::warning(this, tr("导入"), tr("无法导入文件 \"%1\"").arg(path));
+        return;
+    }
+
+    m_categoryTree->refreshTree();
+    m_noteList->refreshList();
+    updateStatusBar();
+    m_statusWidget->showMessage(tr("导入完成"));
+}
+
+/**
+ * @brief 导出全部笔记和分类为 JSON 文件
+ */
+void MainWindow::onExportData()
+{
+    QString path = QFileDialog::getSaveFileName(this, tr("导出"),
+        "notepad_export.json", tr("JSON 文件 (*.json)"));
+    if (path.isEmpty()) return;
+
+    QProgressDialog progress(tr("正在导出..."), tr("取消"), 0, 100, this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+    bool ok = NoteManager::instance()->exportToJson(path, [&progress](qint64 done, qint64 total) {
+        progress.setValue(total > 0 ? int(done * 100 / total) : 100);
+        return !progress.wasCanceled();
+    });
+    const bool canceled = progress.wasCanceled();
+    progress.reset();
+
+    if (canceled) {
+        m_statusWidget->showMessage(tr("导出已取消"));
+        return;
+    }
+    if (!ok) {
+        QMessageBox::warning(this, tr("导出"), tr("无法写入文件 \"%1\"").arg(path));
+        return;
+    }
+    m_statusWidget->showMessage(tr("导出完成"));
+}
+
 void MainWindow::onNewCategory()
 {
     CategoryDialog dialog(this);
@@ -443,8 +566,11 @@ void MainWindow::onDeleteCategory(const QString &categoryId)
     Category *cat = NoteManager::instance()->getCategory(categoryId);
     if (!cat) return;
 
-    int ret = QMessageBox::question(this, tr("删除分类"),
-        tr("确定要删除分类 \"%1\" 吗？").arg(cat->name()),
+    const int noteCount = NoteManager::instance()->noteCountInCategory(categoryId);
+    const QString message = noteCount > 0
+        ? tr("分类 \"%1\" 中有 %2 篇笔记，确定要删除这个分类吗？").arg(cat->name()).arg(noteCount)
+        : tr("确定要删除分类 \"%1\" 吗？").arg(cat->name());
+    int ret = QMessageBox::question(this, tr("删除分类"), message,
         QMessageBox::Yes | QMessageBox::No);
 
     if (ret == QMessageBox::Yes) {
@@ -456,12 +582,17 @@ void MainWindow::onDeleteCategory(const QString &categoryId)
 
 void MainWindow::onNoteSelected(const QString &noteId)
 {
-    // 保存当前笔记
+    NoteManager *manager = NoteManager::instance();
+
+    // 保存当前笔记，不再编辑时释放它的句柄
     if (m_currentNote && m_editor->isModified()) {
         m_currentNote->setContent(m_editor->toHtml());
     }
+    if (m_currentNote && m_currentNote->id() != noteId) {
+        manager->closeNote(m_currentNote->id());
+    }
 
-    m_currentNote = NoteManager::instance()->getNote(noteId);
+    m_currentNote = manager->openNote(noteId);
     if (m_currentNote) {
         m_editor->setHtml(m_currentNote->content());
         m_editor->setModified(false);
@@ -485,32 +616,62 @@ void MainWindow::onCategorySelected(const QString &categoryId)
     // 根据分类过滤笔记列表
     m_noteList->clear();
 
-    QList<Note*> notes;
-    if (categoryId.isEmpty()) {
-        // 未选择分类时显示所有笔记
-        notes = NoteManager::instance()->getAllNotes();
-    } else {
-        // 显示指定分类下的笔记
-        notes = NoteManager::instance()->getNotesByCategory(categoryId);
-    }
+    // 未选择分类时显示所有笔记；置顶笔记排在前面
+    const QStringList noteIds = NoteManager::instance()->getNoteIdsPinnedFirst(categoryId);
 
-    for (Note *note : notes) {
-        m_noteList->addNote(note);
+    for (const QString &noteId : noteIds) {
+        m_noteList->addNote(noteId);
     }
 }
 
 void MainWindow::onSearchRequested(const QString &text)
 {
+    NoteManager *manager = NoteManager::instance();
     if (text.isEmpty()) {
+        manager->cancelSearch();
         m_noteList->refreshList();
         return;
     }
 
-    // 搜索笔记
-    QList<Note*> results = NoteManager::instance()->searchNotes(text);
+    // 在后台搜索，命中边查边追加到列表，全部完成后再换成排好序的结果
+    m_noteList->clear();
+    NoteManager::SearchMode mode = NoteManager::KeywordSearch;
+    if (m_searchWidget->isRegexMode()) {
+        mode = NoteManager::RegexSearch;
+    } else if (m_searchWidget->isFuzzyMode()) {
+        mode = NoteManager::FuzzyTitleSearch;
+    }
+    manager->searchNotesAsync(text, mode);
+}
+
+/**
+ * @brief 后台搜索送回一批命中，追加到列表末尾
+ * @param noteIds 命中的笔记ID（未排序；NoteManager 保证合计不超过搜索的 limit）
+ */
+void MainWindow::onSearchResultsAvailable(const QStringList &noteIds)
+{
+    for (const QString &noteId : noteIds) {
+        m_noteList->addNote(noteId);
+    }
+}
+
+/**
+ * @brief 后台搜索完成，用按相关度排好序的结果替换列表
+ * @param rankedNoteIds 排序并截取前若干条后的笔记ID
+ *
+ * 用户可能已经在部分结果中选中了笔记，替换时保留选中项，
+ * 并屏蔽列表信号，避免重新加载编辑器
+ */
+void MainWindow::onSearchFinished(const QStringList &rankedNoteIds)
+{
+    const QString currentId = m_noteList->currentNoteId();
+    const QSignalBlocker blocker(m_noteList);
     m_noteList->clear();
-    for (Note *note : results) {
-        m_noteList->addNote(note);
+    for (const QString &noteId : rankedNoteIds) {
+        m_noteList->addNote(noteId);
+    }
+    if (!currentId.isEmpty()) {
+        m_noteList->setCurrentNoteId(currentId);
     }
 }
 
@@ -518,20 +679,19 @@ void MainWindow::onSearchRequested(const QString &text)
  * @brief 重命名笔记
  * @param noteId 笔记ID
  *
- * 弹出输入对话框让用户输入新名称
+ * 弹出输入对话框让用户输入新名称；列表项通过 notesModified() 自动刷新
  */
 void MainWindow::onRenameNote(const QString &noteId)
 {
-    Note *note = NoteManager::instance()->getNote(noteId);
-    if (!note) return;
+    NoteManager *manager = NoteManager::instance();
+    if (!manager->hasNote(noteId)) return;
 
     bool ok;
     QString newTitle = QInputDialog::getText(this, tr("重命名笔记"),
-        tr("请输入新名称:"), QLineEdit::Normal, note->title(), &ok);
+        tr("请输入新名称:"), QLineEdit::Normal, manager->noteTitle(noteId), &ok);
 
     if (ok && !newTitle.trimmed().isEmpty()) {
-        note->setTitle(newTitle.trimmed());
-        m_noteList->updateNote(note);
+        manager->setNoteTitle(noteId, newTitle.trimmed());
         updateWindowTitle();
         m_statusWidget->showMessage(tr("笔记已重命名"));
     }
@@ -539,16 +699,15 @@ void MainWindow::onRenameNote(const QString &noteId)
 
 void MainWindow::onShowNoteProperties(const QString &noteId)
 {
-    Note *note = NoteManager::instance()->getNote(noteId);
-    if (!note) return;
+    NoteManager *manager = NoteManager::instance();
+    if (!manager->hasNote(noteId)) return;
 
     NotePropertiesDialog dialog(this);
-    dialog.setNote(note);
+    dialog.setNoteId(noteId);
 
     if (dialog.exec() == QDialog::Accepted) {
-        note->setTitle(dialog.noteTitle());
-        note->setCategoryId(dialog.categoryId());
-        m_noteList->updateNote(note);
+        manager->setNoteTitle(noteId, dialog.noteTitle());
+        manager->setNoteCategoryId(noteId, dialog.categoryId());
         updateWindowTitle();
     }
 }
@@ -556,7 +715,9 @@ void MainWindow::onShowNoteProperties(const QString &noteId)
 void MainWindow::onShowSettings()
 {
     SettingsDialog dialog(this);
-    dialog.exec();
+    if (dialog.exec() == QDialog::Accepted) {
+        applyStorageSettings();
+    }
 }
 
 void MainWindow::onShowAbout()
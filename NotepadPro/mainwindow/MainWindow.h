@@ -18,6 +18,7 @@
 #include <QStatusBar>
 #include <QDockWidget>
 #include <QSplitter>
+#include <QStringList>
 #include <QTimer>
 
 class NoteListWidget;
@@ -54,6 +55,7 @@ private:
     void connectSignals();
     void loadSettings();
     void saveSettings();
+    void applyStorageSettings();
 
     void updateWindowTitle();
     void updateStatusBar();
@@ -63,6 +65,8 @@ private slots:
     void onNewNote();
     void onSaveNote();
     void onDeleteNote();
+    void onImportData();
+    void onExportData();
 
     // 分类操作
     void onNewCategory();
@@ -75,6 +79,8 @@ private slots:
 
     // 搜索
     void onSearchRequested(const QString &text);
+    void onSearchResultsAvailable(const QStringList &noteIds);
+    void onSearchFinished(const QStringList &rankedNoteIds);
 
     // 对话框
     void onShowNoteProperties(const QString &noteId);
@@ -100,6 +106,8 @@ private:
     QAction *m_newNoteAction;
     QAction *m_saveNoteAction;
     QAction *m_deleteNoteAction;
+    QAction *m_importAction;
+    QAction *m_exportAction;
     QAction *m_settingsAction;
     QAction *m_exitAction;
     QAction *m_aboutAction;
@@ -124,7 +132,7 @@ private:
     StatusWidget *m_statusWidget;
 
     // 状态
-    Note *m_currentNote;
+    Note *m_currentNote;            // 编辑中的笔记句柄（NoteManager::openNote()）
     QString m_currentCategoryId;
     QTimer *m_autoSaveTimer;
 };
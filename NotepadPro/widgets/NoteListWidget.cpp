@@ -8,10 +8,10 @@
  * - QContextMenuEvent 右键菜单事件处理
  * - Lambda 表达式在信号槽中的应用
  * - 信号转发模式（将内部信号转换为外部信号）
+ * - 列表项只保存笔记ID，显示内容从 NoteManager 读取
  */
 
 #include "NoteListWidget.h"
-#include "Note.h"
 #include "NoteManager.h"
 
 #include <QContextMenuEvent>
@@ -94,6 +94,16 @@ void NoteListWidget::connectSignals()
     connect(m_listWidget, &QListWidget::currentItemChanged,
             this, &NoteListWidget::onCurrentItemChanged);
 
+    // 标题或正文变化时刷新对应的列表项（其他字段不影响显示）
+    connect(NoteManager::instance(), &NoteManager::notesModified, this,
+            [this](const QStringList &ids, NoteManager::NoteFields fields) {
+        if (fields & (NoteManager::TitleField | NoteManager::ContentField)) {
+            for (const QString &id : ids) {
+                updateNote(id);
+            }
+        }
+    });
+
     // 上下文菜单动作 - 使用 Lambda 获取当前选中项ID
     connect(m_newNoteAction, &QAction::triggered,
             this, &NoteListWidget::createNoteRequested);
@@ -119,19 +129,20 @@ void NoteListWidget::connectSignals()
 
 /**
  * @brief 添加笔记到列表
- * @param note 笔记对象指针
+ * @param noteId 笔记ID
  *
  * 知识点：
  * - QListWidgetItem 的动态创建
  * - 数据与显示分离：使用 Qt::UserRole 存储笔记ID
  */
-void NoteListWidget::addNote(Note *note)
+void NoteListWidget::addNote(const QString &noteId)
 {
-    if (!note) return;
+    if (!NoteManager::instance()->hasNote(noteId)) return;
 
     QListWidgetItem *item = new QListWidgetItem(m_listWidget);
-    updateItemFromNote(item, note);
+    updateItemFromNote(item, noteId);
     m_listWidget->addItem(item);
+    m_items.insert(NoteId::find(noteId), item);
 }
 
 /**
@@ -146,20 +157,20 @@ void NoteListWidget::removeNote(const QString &noteId)
 {
     QListWidgetItem *item = findItemByNoteId(noteId);
     if (item) {
+        m_items.remove(NoteId::find(noteId));
         delete m_listWidget->takeItem(m_listWidget->row(item));
     }
 }
 
 /**
  * @brief 更新列表中的笔记显示
- * @param note 笔记对象指针
+ * @param noteId 笔记ID
  */
-void NoteListWidget::updateNote(Note *note)
+void NoteListWidget::updateNote(const QString &noteId)
 {
-    if (!note) return;
-    QListWidgetItem *item = findItemByNoteId(note->id());
+    QListWidgetItem *item = findItemByNoteId(noteId);
     if (item) {
-        updateItemFromNote(item, note);
+        updateItemFromNote(item, noteId);
     }
 }
 
@@ -169,6 +180,7 @@ void NoteListWidget::updateNote(Note *note)
 void NoteListWidget::clear()
 {
     m_listWidget->clear();
+    m_items.clear();
 }
 
 /**
@@ -203,14 +215,14 @@ void NoteListWidget::setCurrentNoteId(const QString &noteId)
 /**
  * @brief 刷新笔记列表
  *
- * 从 NoteManager 获取所有笔记并重新填充列表
+ * 从 NoteManager 获取所有笔记并重新填充列表（置顶笔记在前）
  */
 void NoteListWidget::refreshList()
 {
     clear();
-    QList<Note*> notes = NoteManager::instance()->getAllNotes();
-    for (Note *note : notes) {
-        addNote(note);
+    const QStringList noteIds = NoteManager::instance()->getNoteIdsPinnedFirst();
+    for (const QString &noteId : noteIds) {
+        addNote(noteId);
     }
 }
 
@@ -232,36 +244,29 @@ void NoteListWidget::contextMenuEvent(QContextMenuEvent *event)
  * @param noteId 笔记ID
  * @return 找到的列表项指针，未找到返回 nullptr
  *
- * 知识点：
- * - 遍历 QListWidget 的方式：count() + item(i)
- * - Qt::UserRole 存储的自定义数据检索
+ * 查 m_items 索引，O(1)；列表很长时逐项比较 Qt::UserRole 中的字符串太慢
  */
 QListWidgetItem* NoteListWidget::findItemByNoteId(const QString &noteId)
 {
-    for (int i = 0; i < m_listWidget->count(); ++i) {
-        QListWidgetItem *item = m_listWidget->item(i);
-        if (item->data(Qt::UserRole).toString() == noteId) {
-            return item;
-        }
-    }
-    return nullptr;
+    return m_items.value(NoteId::find(noteId), nullptr);
 }
 
 /**
- * @brief 从笔记对象更新列表项显示
+ * @brief 从笔记数据更新列表项显示
  * @param item 列表项指针
- * @param note 笔记对象指针
+ * @param noteId 笔记ID
  *
  * 知识点：
  * - setText() 设置显示文本
  * - setToolTip() 设置鼠标悬停提示
  * - setData(Qt::UserRole, ...) 存储自定义数据
  */
-void NoteListWidget::updateItemFromNote(QListWidgetItem *item, Note *note)
+void NoteListWidget::updateItemFromNote(QListWidgetItem *item, const QString &noteId)
 {
-    item->setText(note->title());
-    item->setToolTip(note->preview());
-    item->setData(Qt::UserRole, note->id());
+    NoteManager *manager = NoteManager::instance();
+    item->setText(manager->noteTitle(noteId));
+    item->setToolTip(manager->notePreview(noteId));
+    item->setData(Qt::UserRole, noteId);
 }
 
 /**
@@ -7,6 +7,7 @@
  * - 自定义 QListWidgetItem
  * - 右键上下文菜单
  * - 信号槽连接
+ * - 笔记ID → 列表项的哈希索引，按ID查找列表项不必遍历
  */
 
 #ifndef NOTELISTWIDGET_H
@@ -17,7 +18,7 @@
 #include <QVBoxLayout>
 #include <QMenu>
 
-class Note;
+#include "NoteId.h"
 
 /**
  * @class NoteListWidget
@@ -34,9 +35,9 @@ public:
     ~NoteListWidget() override = default;
 
     // 笔记操作
-    void addNote(Note *note);
+    void addNote(const QString &noteId);
     void removeNote(const QString &noteId);
-    void updateNote(Note *note);
+    void updateNote(const QString &noteId);
     void clear();
 
     // 选择操作
@@ -63,7 +64,7 @@ private:
     void connectSignals();
 
     QListWidgetItem* findItemByNoteId(const QString &noteId);
-    void updateItemFromNote(QListWidgetItem *item, Note *note);
+    void updateItemFromNote(QListWidgetItem *item, const QString &noteId);
 
 private slots:
     void onItemClicked(QListWidgetItem *item);
@@ -80,6 +81,8 @@ private:
     QAction *m_renameNoteAction;   // 新增：重命名动作
     QAction *m_deleteNoteAction;
     QAction *m_propertiesAction;
+
+    NoteIdHash<QListWidgetItem*> m_items;  // 笔记ID → 列表项
 };
 
 #endif // NOTELISTWIDGET_H
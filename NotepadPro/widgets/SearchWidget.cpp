@@ -7,11 +7,15 @@
  * - QTimer 延迟搜索（防抖动）
  * - eventFilter 事件过滤器拦截键盘事件
  * - 信号槽实现搜索功能
+ * - QRegularExpression::isValid() 检查用户输入的正则表达式
+ * - QSignalBlocker 临时屏蔽信号，切换互斥按钮时只触发一次搜索
  */
 
 #include "SearchWidget.h"
 
 #include <QKeyEvent>
+#include <QRegularExpression>
+#include <QSignalBlocker>
 
 /**
  * @brief 构造函数
@@ -47,7 +51,19 @@ void SearchWidget::setupUi()
     m_clearButton = new QPushButton(tr("清除"), this);
     m_clearButton->setVisible(false);
 
+    m_regexButton = new QPushButton(".*", this);
+    m_regexButton->setCheckable(true);
+    m_regexButton->setToolTip(tr("使用正则表达式搜索"));
+    m_regexButton->setMaximumWidth(40);
+
+    m_fuzzyButton = new QPushButton("~", this);
+    m_fuzzyButton->setCheckable(true);
+    m_fuzzyButton->setToolTip(tr("按标题模糊搜索（允许拼写错误）"));
+    m_fuzzyButton->setMaximumWidth(40);
+
     m_layout->addWidget(m_searchEdit);
+    m_layout->addWidget(m_regexButton);
+    m_layout->addWidget(m_fuzzyButton);
     m_layout->addWidget(m_clearButton);
 
     // 搜索延迟定时器
@@ -66,6 +82,10 @@ void SearchWidget::connectSignals()
             this, &SearchWidget::onSearchTimeout);
     connect(m_clearButton, &QPushButton::clicked,
             this, &SearchWidget::onClearClicked);
+    connect(m_regexButton, &QPushButton::toggled,
+            this, &SearchWidget::onRegexToggled);
+    connect(m_fuzzyButton, &QPushButton::toggled,
+            this, &SearchWidget::onFuzzyToggled);
 }
 
 /**
@@ -113,6 +133,42 @@ void SearchWidget::setSearchDelay(int msec)
     m_searchDelay = msec;
 }
 
+/**
+ * @brief 是否为正则表达式模式
+ * @return 正则模式返回 true
+ */
+bool SearchWidget::isRegexMode() const
+{
+    return m_regexButton->isChecked();
+}
+
+/**
+ * @brief 设置正则表达式模式
+ * @param enabled 是否启用
+ */
+void SearchWidget::setRegexMode(bool enabled)
+{
+    m_regexButton->setChecked(enabled);
+}
+
+/**
+ * @brief 是否为标题模糊匹配模式
+ * @return 模糊模式返回 true
+ */
+bool SearchWidget::isFuzzyMode() const
+{
+    return m_fuzzyButton->isChecked();
+}
+
+/**
+ * @brief 设置标题模糊匹配模式
+ * @param enabled 是否启用
+ */
+void SearchWidget::setFuzzyMode(bool enabled)
+{
+    m_fuzzyButton->setChecked(enabled);
+}
+
 /**
  * @brief 事件过滤器
  * @param watched 被监视的对象
@@ -155,6 +211,7 @@ void SearchWidget::onTextChanged(const QString &text)
 {
     // 显示/隐藏清除按钮
     m_clearButton->setVisible(!text.isEmpty());
+    updateRegexState();
 
     // 发送文本变化信号
     emit searchTextChanged(text);
@@ -182,3 +239,63 @@ void SearchWidget::onClearClicked()
     clearSearch();
     m_searchEdit->setFocus();
 }
+
+/**
+ * @brief 正则模式切换处理
+ * @param checked 是否启用正则模式
+ *
+ * 已有搜索文本时立即按新模式重新搜索
+ */
+void SearchWidget::onRegexToggled(bool checked)
+{
+    if (checked) {
+        const QSignalBlocker blocker(m_fuzzyButton);
+        m_fuzzyButton->setChecked(false);
+    }
+    updateRegexState();
+    if (!m_searchEdit->text().isEmpty()) {
+        m_searchTimer->stop();
+        emit searchRequested(m_searchEdit->text());
+    }
+}
+
+/**
+ * @brief 模糊模式切换处理
+ * @param checked 是否启用模糊模式
+ *
+ * 与正则模式互斥；已有搜索文本时立即按新模式重新搜索
+ */
+void SearchWidget::onFuzzyToggled(bool checked)
+{
+    if (checked) {
+        const QSignalBlocker blocker(m_regexButton);
+        m_regexButton->setChecked(false);
+    }
+    updateRegexState();
+    if (!m_searchEdit->text().isEmpty()) {
+        m_searchTimer->stop();
+        emit searchRequested(m_searchEdit->text());
+    }
+}
+
+/**
+ * @brief 正则模式下表达式无效时把文字标红，并在提示中显示错误原因
+ */
+void SearchWidget::updateRegexState()
+{
+    QString error;
+    if (isRegexMode() && !m_searchEdit->text().isEmpty()) {
+        const QRegularExpression regex(m_searchEdit->text());
+        if (!regex.isValid()) {
+            error = regex.errorString();
+        }
+    }
+    m_searchEdit->setStyleSheet(error.isEmpty() ? QString() : QString("color: red;"));
+    if (error.isEmpty() && !isRegexMode() && !isFuzzyMode()) {
+        // 普通模式下提示结构化查询语法
+        m_searchEdit->setToolTip(tr("支持 title:词 category:分类 pinned:true updated:>2026-01-01 "
+                                    "\"短语\" -排除（如 -category:分类）"));
+    } else {
+        m_searchEdit->setToolTip(error);
+    }
+}
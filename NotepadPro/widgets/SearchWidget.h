@@ -7,6 +7,7 @@
  * - QTimer 延迟搜索
  * - 事件过滤器
  * - 键盘快捷键
+ * - 可勾选按钮切换正则表达式模式
  */
 
 #ifndef SEARCHWIDGET_H
@@ -41,6 +42,14 @@ public:
     int searchDelay() const;
     void setSearchDelay(int msec);
 
+    // 正则表达式模式
+    bool isRegexMode() const;
+    void setRegexMode(bool enabled);
+
+    // 标题模糊匹配模式（与正则模式互斥）
+    bool isFuzzyMode() const;
+    void setFuzzyMode(bool enabled);
+
 signals:
     void searchTextChanged(const QString &text);
     void searchRequested(const QString &text);
@@ -52,16 +61,21 @@ protected:
 private:
     void setupUi();
     void connectSignals();
+    void updateRegexState();
 
 private slots:
     void onTextChanged(const QString &text);
     void onSearchTimeout();
     void onClearClicked();
+    void onRegexToggled(bool checked);
+    void onFuzzyToggled(bool checked);
 
 private:
     QHBoxLayout *m_layout;
     QLineEdit *m_searchEdit;
     QPushButton *m_clearButton;
+    QPushButton *m_regexButton;
+    QPushButton *m_fuzzyButton;
     QTimer *m_searchTimer;
 
     int m_searchDelay;  // 搜索延迟（毫秒）